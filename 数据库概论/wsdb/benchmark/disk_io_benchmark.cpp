@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+/**
+ * @brief Benchmark of the asynchronous page I/O of the disk manager against the synchronous path it falls back to.
+ * 1. random single-page reads, one pread at a time against up to IO_RING_DEPTH reads in flight through io_uring
+ * 2. FlushAllPages of a file with every page of the buffer pool dirty, with io_depth 0 (synchronous writes) and
+ * IO_RING_DEPTH
+ * Page files are opened with O_DIRECT so that the reads reach the device, on file systems without it (e.g. tmpfs) the
+ * numbers only measure the page cache. Run it on the device holding the database
+ *
+ * usage: disk_io_benchmark [file] [number of pages] [number of reads]
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+#include "storage/buffer/buffer_pool_manager.h"
+#include "storage/disk/disk_manager.h"
+
+namespace wsdb {
+
+static auto Now() -> std::chrono::steady_clock::time_point { return std::chrono::steady_clock::now(); }
+
+static auto ElapsedMs(std::chrono::steady_clock::time_point start) -> double
+{
+  return std::chrono::duration<double, std::milli>(Now() - start).count();
+}
+
+static void CreatePageFile(const std::string &fname, size_t num_pages)
+{
+  if (DiskManager::FileExists(fname)) {
+    DiskManager::DestroyFile(fname);
+  }
+  DiskManager::CreateFile(fname);
+  DiskManager               disk_manager(0);
+  auto                      fid = disk_manager.OpenFile(fname);
+  std::vector<char>         data(PAGE_SIZE * 64, 'x');
+  std::vector<const char *> pages(64);
+  for (size_t i = 0; i < pages.size(); i++) {
+    pages[i] = &data[i * PAGE_SIZE];
+  }
+  for (size_t pid = 0; pid < num_pages; pid += pages.size()) {
+    disk_manager.WritePages(fid, static_cast<page_id_t>(pid), pages);
+  }
+  disk_manager.CloseFile(fid);
+}
+
+/**
+ * @return milliseconds to read the pages one after another, or with up to io_depth reads in flight
+ */
+static auto RandomReads(const std::string &fname, const std::vector<page_id_t> &pids, size_t io_depth) -> double
+{
+  DiskManager disk_manager(io_depth, true);
+  auto        fid = disk_manager.OpenFile(fname, true);
+  auto        buf = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE * IO_RING_DEPTH));
+  auto        start = Now();
+  if (io_depth == 0) {
+    for (page_id_t pid : pids) {
+      disk_manager.ReadPage(fid, pid, buf);
+    }
+  } else {
+    std::deque<std::pair<io_ticket_t, size_t>> in_flight;
+    for (size_t i = 0; i < pids.size(); i++) {
+      size_t slot = i % IO_RING_DEPTH;
+      if (in_flight.size() == IO_RING_DEPTH) {
+        disk_manager.WaitIO(in_flight.front().first);
+        in_flight.pop_front();
+      }
+      in_flight.emplace_back(disk_manager.SubmitReadPages(fid, pids[i], {buf + slot * PAGE_SIZE}), slot);
+    }
+    for (auto &[ticket, slot] : in_flight) {
+      disk_manager.WaitIO(ticket);
+    }
+  }
+  double ms = ElapsedMs(start);
+  std::free(buf);
+  disk_manager.CloseFile(fid);
+  return ms;
+}
+
+/**
+ * @return milliseconds of FlushAllPages with every page of the pool dirty
+ */
+static auto FlushPool(const std::string &fname, size_t pool_size, size_t io_depth) -> double
+{
+  DiskManager disk_manager(io_depth, true);
+  auto        fid = disk_manager.OpenFile(fname, true);
+  double      ms;
+  {
+    BufferPoolManager buffer_pool_manager(&disk_manager, nullptr, 2, 1, "LRUReplacer", pool_size);
+    for (size_t pid = 0; pid < pool_size; pid++) {
+      auto guard             = buffer_pool_manager.FetchPageWrite(fid, static_cast<page_id_t>(pid));
+      guard.GetData()[64] = static_cast<char>(pid);
+    }
+    auto start = Now();
+    buffer_pool_manager.FlushAllPages(fid);
+    ms = ElapsedMs(start);
+  }
+  disk_manager.CloseFile(fid);
+  return ms;
+}
+
+}  // namespace wsdb
+
+auto main(int argc, char **argv) -> int
+{
+  using namespace wsdb;  // NOLINT
+  std::string fname     = argc > 1 ? argv[1] : "disk_io_benchmark.db";
+  size_t      num_pages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 65536;
+  size_t      num_reads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 65536;
+
+  CreatePageFile(fname, num_pages);
+  {
+    DiskManager disk_manager(IO_RING_DEPTH, true);
+    auto        fid = disk_manager.OpenFile(fname, true);
+    fmt::print("{} pages of {} bytes, io_uring: {}, O_DIRECT: {}\n", num_pages, PAGE_SIZE,
+        disk_manager.UsesIOUring(), disk_manager.IsDirectIO(fid));
+    disk_manager.CloseFile(fid);
+  }
+
+  std::mt19937                             rng(42);
+  std::uniform_int_distribution<page_id_t> dist(0, static_cast<page_id_t>(num_pages) - 1);
+  std::vector<page_id_t>                   pids(num_reads);
+  for (auto &pid : pids) {
+    pid = dist(rng);
+  }
+  double sync_ms  = RandomReads(fname, pids, 0);
+  double async_ms = RandomReads(fname, pids, IO_RING_DEPTH);
+  fmt::print("random reads      sync {:>10.0f} pages/s   io_uring {:>10.0f} pages/s\n",
+      static_cast<double>(num_reads) * 1000 / sync_ms, static_cast<double>(num_reads) * 1000 / async_ms);
+
+  size_t pool_size     = std::min<size_t>(num_pages, 16384);
+  double sync_flush_ms = FlushPool(fname, pool_size, 0);
+  double flush_ms      = FlushPool(fname, pool_size, IO_RING_DEPTH);
+  fmt::print("flush {:>6} pages sync {:>10.1f} ms        io_uring {:>10.1f} ms\n", pool_size, sync_flush_ms, flush_ms);
+
+  DiskManager::DestroyFile(fname);
+  return 0;
+}
@@ -0,0 +1,164 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+/**
+ * @brief Benchmark of GroupCommitLog against a log where each commit writes and syncs its own record under a mutex.
+ * Every thread commits its records one after another, a commit appends a record and waits until it is durable, the
+ * thread count is raised to show how the groups grow with the number of concurrent commits.
+ * It reports commits per second, the average and the longest commit, and the records made durable per fdatasync.
+ * On file systems that ignore fdatasync (e.g. tmpfs) the numbers only measure the locking, run it on the device
+ * holding the database
+ *
+ * usage: group_commit_benchmark [file] [commits per thread] [record size]
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/group_commit_log.h"
+
+namespace wsdb {
+
+static auto Now() -> std::chrono::steady_clock::time_point { return std::chrono::steady_clock::now(); }
+
+static auto ElapsedNs(std::chrono::steady_clock::time_point start) -> uint64_t
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Now() - start).count());
+}
+
+struct CommitResult
+{
+  double   ms_{0};           // wall time of all the commits
+  uint64_t wait_ns_{0};      // sum of the commit latencies
+  uint64_t max_wait_ns_{0};  // the longest commit
+  size_t   syncs_{0};
+};
+
+static void RemoveFile(const std::string &fname)
+{
+  if (DiskManager::FileExists(fname)) {
+    DiskManager::DestroyFile(fname);
+  }
+}
+
+/**
+ * Run num_threads threads of num_commits commits each, commit(record) must return when the record is durable
+ */
+template <typename F>
+static auto RunCommits(size_t num_threads, size_t num_commits, size_t record_size, F &&commit) -> CommitResult
+{
+  std::vector<uint64_t>    wait_ns(num_threads, 0);
+  std::vector<uint64_t>    max_wait_ns(num_threads, 0);
+  std::vector<std::thread> threads;
+  auto                     start = Now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::string record(record_size, static_cast<char>('a' + t % 26));
+      for (size_t i = 0; i < num_commits; i++) {
+        auto commit_start = Now();
+        commit(record);
+        auto ns        = ElapsedNs(commit_start);
+        wait_ns[t]    += ns;
+        max_wait_ns[t] = std::max(max_wait_ns[t], ns);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CommitResult result;
+  result.ms_ = static_cast<double>(ElapsedNs(start)) / 1e6;
+  for (size_t t = 0; t < num_threads; t++) {
+    result.wait_ns_ += wait_ns[t];
+    result.max_wait_ns_ = std::max(result.max_wait_ns_, max_wait_ns[t]);
+  }
+  return result;
+}
+
+static auto GroupCommit(const std::string &fname, size_t num_threads, size_t num_commits, size_t record_size)
+    -> CommitResult
+{
+  RemoveFile(fname);
+  CommitResult result;
+  {
+    GroupCommitLog log(fname);
+    result = RunCommits(num_threads, num_commits, record_size, [&](const std::string &record) {
+      log.WaitDurable(log.Append(record.data(), record.size()));
+    });
+    result.syncs_ = log.GetStats().syncs_;
+  }
+  RemoveFile(fname);
+  return result;
+}
+
+/**
+ * @return the log written as before group commit, one write and one fdatasync per commit under a mutex
+ */
+static auto SyncPerCommit(const std::string &fname, size_t num_threads, size_t num_commits, size_t record_size)
+    -> CommitResult
+{
+  RemoveFile(fname);
+  int        fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  std::mutex latch;
+  auto       result = RunCommits(num_threads, num_commits, record_size, [&](const std::string &record) {
+    std::lock_guard<std::mutex> lock(latch);
+    if (write(fd, record.data(), record.size()) != static_cast<ssize_t>(record.size()) || fdatasync(fd) != 0) {
+      fmt::print(stderr, "write {} failed\n", fname);
+      std::exit(1);
+    }
+  });
+  close(fd);
+  result.syncs_ = num_threads * num_commits;
+  RemoveFile(fname);
+  return result;
+}
+
+static void PrintResult(const char *name, size_t num_commits, const CommitResult &result)
+{
+  fmt::print("  {:<16} {:>10.0f} commits/s   avg {:>8.3f} ms   max {:>8.3f} ms   {:>6.1f} records/sync\n", name,
+      static_cast<double>(num_commits) * 1000 / result.ms_,
+      static_cast<double>(result.wait_ns_) / 1e6 / static_cast<double>(num_commits),
+      static_cast<double>(result.max_wait_ns_) / 1e6,
+      static_cast<double>(num_commits) / static_cast<double>(std::max<size_t>(result.syncs_, 1)));
+}
+
+}  // namespace wsdb
+
+auto main(int argc, char **argv) -> int
+{
+  using namespace wsdb;  // NOLINT
+  std::string fname       = argc > 1 ? argv[1] : "group_commit_benchmark.log";
+  size_t      num_commits = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+  size_t      record_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 128;
+
+  for (size_t num_threads : {1, 4, 16, 64}) {
+    size_t total = num_threads * num_commits;
+    fmt::print("{} threads x {} commits of {} bytes\n", num_threads, num_commits, record_size);
+    PrintResult("sync per commit", total, SyncPerCommit(fname, num_threads, num_commits, record_size));
+    PrintResult("group commit", total, GroupCommit(fname, num_threads, num_commits, record_size));
+  }
+  return 0;
+}
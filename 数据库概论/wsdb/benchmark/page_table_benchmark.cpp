@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+/**
+ * @brief Microbenchmark of the shard PageTable against the std::unordered_map keyed by fid ^ pid that it replaced.
+ * The table is filled with every other page of a few files, as a buffer pool holding part of each table would be, the
+ * pages in between are the misses. It measures hit and miss lookups, erase and reinsert, and how many keys collide
+ *
+ * usage: page_table_benchmark [number of pages] [number of files]
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "storage/buffer/page_table.h"
+
+namespace wsdb {
+
+/** The hash of fid_pid_t before the page table was replaced, consecutive pages of different files collide */
+struct BaselinePageHash
+{
+  auto operator()(const fid_pid_t &fp) const -> size_t
+  {
+    return std::hash<table_id_t>()(fp.fid) ^ std::hash<frame_id_t>()(fp.pid);
+  }
+};
+
+using BaselinePageTable = std::unordered_map<fid_pid_t, frame_id_t, BaselinePageHash>;
+
+template <typename F>
+static auto TimeNs(size_t ops, F &&f) -> double
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+         static_cast<double>(ops);
+}
+
+}  // namespace wsdb
+
+auto main(int argc, char **argv) -> int
+{
+  using namespace wsdb;  // NOLINT
+  size_t num_pages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 65536;
+  size_t num_files = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+  size_t num_ops   = 1 << 24;
+
+  std::vector<fid_pid_t> keys;
+  for (size_t i = 0; i < num_pages; i++) {
+    keys.push_back({static_cast<file_id_t>(i % num_files), static_cast<page_id_t>(i / num_files * 2)});
+  }
+  std::mt19937                          rng(42);
+  std::vector<fid_pid_t>                hits(1 << 20), misses(1 << 20);
+  std::vector<frame_id_t>               hit_frames(1 << 20);
+  std::uniform_int_distribution<size_t> dist(0, num_pages - 1);
+  for (size_t i = 0; i < hits.size(); i++) {
+    hit_frames[i] = static_cast<frame_id_t>(dist(rng));
+    hits[i]       = keys[hit_frames[i]];
+    misses[i]     = {hits[i].fid, hits[i].pid + 1};
+  }
+  size_t mask = hits.size() - 1;
+
+  BaselinePageTable baseline;
+  PageTable         table(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    baseline[keys[i]] = static_cast<frame_id_t>(i);
+    table.Insert(keys[i], static_cast<frame_id_t>(i));
+  }
+
+  // keys sharing their bucket with another key for the baseline, keys not in their home slot for the page table
+  size_t baseline_collisions = 0, collisions = 0, probes = 0;
+  for (const auto &key : keys) {
+    baseline_collisions += baseline.bucket_size(baseline.bucket(key)) > 1 ? 1 : 0;
+    size_t probe_length = table.GetProbeLength(key);
+    collisions += probe_length > 1 ? 1 : 0;
+    probes += probe_length;
+  }
+
+  int64_t sum = 0;
+  double  baseline_hit_ns = TimeNs(num_ops, [&] {
+    for (size_t i = 0; i < num_ops; i++) {
+      sum += baseline.find(hits[i & mask])->second;
+    }
+  });
+  double  hit_ns          = TimeNs(num_ops, [&] {
+    for (size_t i = 0; i < num_ops; i++) {
+      sum += table.Find(hits[i & mask]);
+    }
+  });
+  double  baseline_miss_ns = TimeNs(num_ops, [&] {
+    for (size_t i = 0; i < num_ops; i++) {
+      sum += baseline.count(misses[i & mask]);
+    }
+  });
+  double  miss_ns          = TimeNs(num_ops, [&] {
+    for (size_t i = 0; i < num_ops; i++) {
+      sum += table.Find(misses[i & mask]);
+    }
+  });
+  size_t  churn_ops        = num_ops / 8;
+  double  baseline_churn_ns = TimeNs(churn_ops, [&] {
+    for (size_t i = 0; i < churn_ops; i++) {
+      baseline.erase(hits[i & mask]);
+      baseline[hits[i & mask]] = hit_frames[i & mask];
+    }
+  });
+  double  churn_ns          = TimeNs(churn_ops, [&] {
+    for (size_t i = 0; i < churn_ops; i++) {
+      table.Erase(hits[i & mask]);
+      table.Insert(hits[i & mask], hit_frames[i & mask]);
+    }
+  });
+
+  fmt::print("{} pages of {} files, checksum {}\n", num_pages, num_files, sum);
+  fmt::print("{:<24} {:>12} {:>12}\n", "", "baseline", "PageTable");
+  fmt::print("{:<24} {:>12.1f} {:>12.1f}\n", "hit lookup ns", baseline_hit_ns, hit_ns);
+  fmt::print("{:<24} {:>12.1f} {:>12.1f}\n", "miss lookup ns", baseline_miss_ns, miss_ns);
+  fmt::print("{:<24} {:>12.1f} {:>12.1f}\n", "erase + insert ns", baseline_churn_ns, churn_ns);
+  fmt::print("{:<24} {:>11.1f}% {:>11.1f}%\n", "colliding keys",
+      100.0 * static_cast<double>(baseline_collisions) / static_cast<double>(num_pages),
+      100.0 * static_cast<double>(collisions) / static_cast<double>(num_pages));
+  fmt::print("{:<24} {:>12} {:>12.2f}\n", "mean probe length", "-",
+      static_cast<double>(probes) / static_cast<double>(num_pages));
+  return 0;
+}
@@ -0,0 +1,166 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+/**
+ * @brief Microbenchmark of LRUKReplacer against the implementation it replaced, which scanned every frame twice in
+ * Victim. Each operation is one Victim, then Pin and Unpin of the victim and of a random frame, with k = 2
+ *
+ * usage: replacer_benchmark [seconds per case]
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <limits>
+#include <list>
+#include <mutex>  // NOLINT
+#include <random>
+#include <unordered_map>
+#include "storage/buffer/replacer/lru_k_replacer.h"
+
+namespace wsdb {
+
+/**
+ * The LRU-K replacer before it kept the evictable frames ordered, Victim computes the backward k-distance of every
+ * frame. Kept here only as the baseline of the benchmark
+ */
+class BaselineLRUKReplacer
+{
+public:
+  BaselineLRUKReplacer(size_t num_frames, size_t k) : max_size_(num_frames), k_(k) {}
+
+  auto Victim(frame_id_t *frame_id) -> bool
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (cur_size_ == 0) {
+      return false;
+    }
+    uint64_t max_distance = 0;
+    for (frame_id_t i = 0; i < static_cast<frame_id_t>(max_size_); i++) {
+      if (node_store_[i].evictable_ && node_store_[i].GetBackwardKDistance(cur_ts_, k_) > max_distance) {
+        max_distance = node_store_[i].GetBackwardKDistance(cur_ts_, k_);
+        *frame_id    = i;
+      }
+    }
+    if (max_distance == std::numeric_limits<uint64_t>::max()) {
+      timestamp_t min_timestamp = std::numeric_limits<timestamp_t>::max();
+      for (frame_id_t i = 0; i < static_cast<frame_id_t>(max_size_); i++) {
+        if (node_store_[i].evictable_ && node_store_[i].GetBackwardKDistance(cur_ts_, k_) == max_distance &&
+            node_store_[i].history_.front() < min_timestamp) {
+          min_timestamp = node_store_[i].history_.front();
+          *frame_id     = i;
+        }
+      }
+    }
+    node_store_[*frame_id].history_.clear();
+    node_store_[*frame_id].evictable_ = false;
+    cur_size_--;
+    return true;
+  }
+
+  void Pin(frame_id_t frame_id)
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    auto                       &node = node_store_[frame_id];
+    node.history_.push_back(cur_ts_++);
+    if (node.history_.size() > k_) {
+      node.history_.pop_front();
+    }
+    if (node.evictable_) {
+      node.evictable_ = false;
+      cur_size_--;
+    }
+  }
+
+  void Unpin(frame_id_t frame_id)
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    auto                       &node = node_store_[frame_id];
+    if (!node.evictable_) {
+      node.evictable_ = true;
+      cur_size_++;
+    }
+  }
+
+private:
+  struct Node
+  {
+    auto GetBackwardKDistance(timestamp_t cur_ts, size_t k) const -> uint64_t
+    {
+      return history_.size() < k ? std::numeric_limits<uint64_t>::max() : cur_ts - history_.front();
+    }
+
+    std::list<timestamp_t> history_;
+    bool                   evictable_{false};
+  };
+
+  std::unordered_map<frame_id_t, Node> node_store_;
+  size_t                               cur_ts_{0};
+  size_t                               cur_size_{0};
+  size_t                               max_size_;
+  size_t                               k_;
+  std::mutex                           latch_;
+};
+
+/**
+ * Run the operation loop on a replacer of num_frames frames for about seconds
+ * @return microseconds per operation
+ */
+template <typename ReplacerT>
+static auto RunReplacer(ReplacerT &replacer, size_t num_frames, double seconds) -> double
+{
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(num_frames); i++) {
+    replacer.Pin(i);
+    replacer.Unpin(i);
+  }
+  std::mt19937                              rng(42);
+  std::uniform_int_distribution<frame_id_t> dist(0, static_cast<frame_id_t>(num_frames) - 1);
+  auto                                      start = std::chrono::steady_clock::now();
+  size_t                                    ops   = 0;
+  double                                    elapsed;
+  do {
+    for (int i = 0; i < 16; i++, ops++) {
+      frame_id_t victim;
+      if (replacer.Victim(&victim)) {
+        replacer.Pin(victim);
+        replacer.Unpin(victim);
+      }
+      frame_id_t frame_id = dist(rng);
+      replacer.Pin(frame_id);
+      replacer.Unpin(frame_id);
+    }
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < seconds);
+  return elapsed * 1e6 / static_cast<double>(ops);
+}
+
+}  // namespace wsdb
+
+auto main(int argc, char **argv) -> int
+{
+  double seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+  fmt::print("{:>8} {:>14} {:>14}\n", "frames", "baseline us/op", "LRUK us/op");
+  for (size_t num_frames : {1024, 8192, 65536}) {
+    wsdb::BaselineLRUKReplacer baseline(num_frames, 2);
+    wsdb::LRUKReplacer         lru_k(num_frames, 2);
+    double                     baseline_us = wsdb::RunReplacer(baseline, num_frames, seconds);
+    double                     lru_k_us    = wsdb::RunReplacer(lru_k, num_frames, seconds);
+    fmt::print("{:>8} {:>14.2f} {:>14.2f}\n", num_frames, baseline_us, lru_k_us);
+  }
+  return 0;
+}
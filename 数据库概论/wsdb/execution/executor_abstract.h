@@ -63,12 +63,30 @@ public:
 
   [[nodiscard]] auto GetType() const -> ExecutorType { return type_; }
 
+  /**
+   * @return whether there is a current record
+   */
+  [[nodiscard]] virtual auto HasRecord() const -> bool { return record_ != nullptr; }
+
+  /**
+   * View the current record without copying it, valid until the next Init or Next. Operators that only look at the
+   * record or derive another one from it should use this instead of GetRecord
+   */
+  [[nodiscard]] virtual auto GetRecordView() const -> RecordView
+  {
+    WSDB_ASSERT(record_ != nullptr, "no current record");
+    return *record_;
+  }
+
+  /**
+   * Copy the current record, for the operators that keep it beyond Next
+   */
   [[nodiscard]] auto GetRecord() -> RecordUptr
   {
-    if (record_ == nullptr) {
+    if (!HasRecord()) {
       return nullptr;
     }
-    return std::make_unique<Record>(*record_);
+    return GetRecordView().ToRecord();
   };
 
 protected:
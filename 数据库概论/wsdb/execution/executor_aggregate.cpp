@@ -54,6 +54,8 @@ AggregateExecutor::AggregateExecutor(
   out_schema_ = std::make_unique<RecordSchema>(fields);
 }
 
+// hint: find the group by a view of the key built from the child record, store group_arena_.Copy(key) only for a new
+// group so that the map keeps one copy of every key and no Record
 void AggregateExecutor::Init() { WSDB_STUDENT_TODO(l3, t3); }
 
 void AggregateExecutor::Next() { WSDB_STUDENT_TODO(l3, t3); }
@@ -23,6 +23,7 @@
 #define WSDB_EXECUTOR_AGGREGATE_H
 #include <unordered_map>
 #include "executor_abstract.h"
+#include "system/handle/record_arena.h"
 
 namespace wsdb {
 
@@ -75,11 +76,14 @@ private:
   };
 
 private:
-  AbstractExecutorUptr                                 child_;
-  RecordSchemaUptr                                     agg_schema_;
-  RecordSchemaUptr                                     group_schema_;
-  std::unordered_map<Record, AggregateValue>           group_map_;
-  std::unordered_map<Record, AggregateValue>::iterator group_iter_;
+  AbstractExecutorUptr child_;
+  RecordSchemaUptr     agg_schema_;
+  RecordSchemaUptr     group_schema_;
+  // the group keys are copied into group_arena_ by RecordArena::Copy when a group is first seen, a lookup of an
+  // existing group can use a view of a temporary key. All keys are released at once with the map
+  RecordArena                                              group_arena_;
+  std::unordered_map<RecordView, AggregateValue>           group_map_;
+  std::unordered_map<RecordView, AggregateValue>::iterator group_iter_;
 };
 
 }  // namespace wsdb
@@ -39,10 +39,13 @@ void DeleteExecutor::Next() {
 	int count = 0;
 	child_->Init();
 	while (!child_->IsEnd()) {
-		auto childRecord = child_->GetRecord();
-		tbl_->DeleteRecord(childRecord->GetRID());
-		for (auto *index : indexes_) {
-		  index->DeleteRecord(*childRecord);
+		auto childRecord = child_->GetRecordView();
+		tbl_->DeleteRecord(childRecord.GetRID());
+		if (!indexes_.empty()) {
+		  auto rec = childRecord.ToRecord();
+		  for (auto *index : indexes_) {
+		    index->DeleteRecord(*rec);
+		  }
 		}
 		count++;
 		child_->Next();
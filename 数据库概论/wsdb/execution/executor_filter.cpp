@@ -32,9 +32,10 @@ void FilterExecutor::Init()
 	record_ = nullptr;
 	//获取一项record
 	while(!child_->IsEnd()) {
+		// the condition is evaluated on a Record, keep it if it passes instead of copying the child record again
 		auto childRecord = child_->GetRecord();
 		if (childRecord && filter_(*childRecord)) {
-			record_ = child_->GetRecord();
+			record_ = std::move(childRecord);
 			return;
 		}
 		child_->Next();
@@ -48,7 +49,7 @@ void FilterExecutor::Next()
 	while(!child_->IsEnd()) {
 	auto childRecord = child_->GetRecord();
 		if (childRecord && filter_(*childRecord)) {
-			record_ = child_->GetRecord();
+			record_ = std::move(childRecord);
 			return;
 		}
 		child_->Next();
@@ -20,6 +20,7 @@
 //
 
 #include "executor_insert.h"
+#include <algorithm>
 
 namespace wsdb {
 
@@ -38,8 +39,10 @@ void InsertExecutor::Next() {
 	if(IsEnd()) {
 		return;
 	}
+	auto strategy = tbl_->GetAccessStrategy(
+	    BufferAccessType::BULK_WRITE, inserts_.size() / std::max<size_t>(tbl_->GetTableHeader().rec_per_page_, 1));
 	for (auto& record : inserts_) {
-		tbl_->InsertRecord(*record);
+		tbl_->InsertRecord(*record, strategy.get());
 		for (auto index : indexes_) {
 			index->InsertRecord(*record);
 		}
@@ -28,6 +28,8 @@
 #define WSDB_EXECUTOR_JOIN_SORTMERGE_H
 
 #include "executor_join.h"
+#include "system/handle/record_arena.h"
+#include "system/handle/record_comparator.h"
 
 namespace wsdb {
 class SortMergeJoinExecutor : public JoinExecutor
@@ -49,17 +51,21 @@ private:
 
   [[nodiscard]] auto IsEndOuterJoin() const -> bool override;
 
-  [[nodiscard]] auto Compare(const Record &left, const Record &right) const -> int;
+  [[nodiscard]] auto Compare(const RecordView &left, const RecordView &right) const -> int;
 
 private:
   RecordSchemaUptr left_key_schema_;
   RecordSchemaUptr right_key_schema_;
+  // compares left records with right records on the key fields
+  RecordComparator comparator_;
 
   // temporarily store record from the left executor
   RecordUptr left_rec_;
-  // buffer to store equal values in right executor
-  size_t                               right_idx_{0};
-  std::vector<std::shared_ptr<Record>> right_buffer_;
+  // buffer to store equal values in right executor, the records are copied into right_arena_ by RecordArena::Copy
+  // and released together by RecordArena::Reset when the key changes
+  size_t                  right_idx_{0};
+  RecordArena             right_arena_;
+  std::vector<RecordView> right_buffer_;
 };
 }  // namespace wsdb
 
@@ -31,7 +31,6 @@ void LimitExecutor::Init() {
 	count_ = 0;
 
 	if(IsEnd()) return;
-	record_ = child_->GetRecord();
 	count_++;
 }
 
@@ -39,11 +38,15 @@ void LimitExecutor::Next() {
 	child_->Next();
 
 	if(IsEnd()) return;
-	record_ = child_->GetRecord();
 	count_++;
 }
 
 [[nodiscard]] auto LimitExecutor::IsEnd() const -> bool { return (count_ > limit_ || child_->IsEnd()); }
 
+auto LimitExecutor::HasRecord() const -> bool { return !IsEnd() && child_->HasRecord(); }
+
+// the records are passed through from the child without copying them
+auto LimitExecutor::GetRecordView() const -> RecordView { return child_->GetRecordView(); }
+
 [[nodiscard]] auto LimitExecutor::GetOutSchema() const -> const RecordSchema * { return child_->GetOutSchema(); }
 }  // namespace wsdb
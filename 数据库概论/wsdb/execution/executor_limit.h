@@ -43,6 +43,10 @@ public:
 
   [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
 
+  [[nodiscard]] auto HasRecord() const -> bool override;
+
+  [[nodiscard]] auto GetRecordView() const -> RecordView override;
+
 private:
   AbstractExecutorUptr child_;
   // max number of records to return
@@ -35,9 +35,8 @@ void ProjectionExecutor::Init() {
 	child_->Init();
 	record_ = nullptr;
 	if(IsEnd()) return;
-	auto childRecord = child_->GetRecord();
-	if(childRecord) {
-		record_ = std::make_unique<Record>(out_schema_.get(), *childRecord);
+	if(child_->HasRecord()) {
+		record_ = std::make_unique<Record>(out_schema_.get(), child_->GetRecordView());
 	}
 }
 
@@ -45,9 +44,8 @@ void ProjectionExecutor::Next() {
 	child_->Next();
 	record_ = nullptr;
 	if (IsEnd()) return;
-	auto childRecord = child_->GetRecord();
-	if(childRecord){
-		record_ = std::make_unique<Record>(out_schema_.get(), *childRecord);
+	if(child_->HasRecord()){
+		record_ = std::make_unique<Record>(out_schema_.get(), child_->GetRecordView());
 	}
 }
 
@@ -27,18 +27,30 @@ SeqScanExecutor::SeqScanExecutor(TableHandle *tab) : AbstractExecutor(Basic), ta
 
 void SeqScanExecutor::Init()
 {
-	rid_ = tab_->GetFirstRID();
-	record_ = tab_->GetRecord(rid_);
+  strategy_ = tab_->GetAccessStrategy(BufferAccessType::BULK_READ, tab_->GetTableHeader().page_num_);
+  // every page is fetched once, the records of a page are handed out from a copy
+  scan_ = std::make_unique<TableScan>(tab_, strategy_.get());
 }
 
 void SeqScanExecutor::Next()
 {
-	rid_ = tab_->GetNextRID(rid_);
-	if (IsEnd()) return;
-	record_ = tab_->GetRecord(rid_);
+  scan_->Next();
+  if (IsEnd()) {
+    // the scan refers to the strategy
+    scan_     = nullptr;
+    strategy_ = nullptr;
+  }
 }
 
-auto SeqScanExecutor::IsEnd() const -> bool{ return (rid_ == INVALID_RID); }
+auto SeqScanExecutor::IsEnd() const -> bool { return scan_ == nullptr || scan_->IsEnd(); }
+
+auto SeqScanExecutor::HasRecord() const -> bool { return !IsEnd(); }
+
+auto SeqScanExecutor::GetRecordView() const -> RecordView
+{
+  WSDB_ASSERT(!IsEnd(), "no current record");
+  return {&tab_->GetSchema(), scan_->GetNullMap(), scan_->GetData(), scan_->GetRID()};
+}
 
 auto SeqScanExecutor::GetOutSchema() const -> const RecordSchema * { return &tab_->GetSchema(); }
 }  // namespace wsdb
\ No newline at end of file
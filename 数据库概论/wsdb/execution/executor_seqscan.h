@@ -43,9 +43,18 @@ public:
 
   [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
 
+  [[nodiscard]] auto HasRecord() const -> bool override;
+
+  /**
+   * View of the current record in the page batch of the scan, no Record is created
+   */
+  [[nodiscard]] auto GetRecordView() const -> RecordView override;
+
 private:
   TableHandle *tab_;
-  RID          rid_;
+  // keeps a large scan in a small ring of frames
+  BufferAccessStrategyUptr strategy_;
+  TableScanUptr            scan_;
 };
 }  // namespace wsdb
 
@@ -30,6 +30,7 @@ SortExecutor::SortExecutor(AbstractExecutorUptr child, RecordSchemaUptr key_sche
     : AbstractExecutor(Basic),
       child_(std::move(child)),
       key_schema_(std::move(key_schema)),
+      comparator_(key_schema_.get(), child_->GetOutSchema(), key_schema_.get(), child_->GetOutSchema()),
       buf_idx_(0),
       is_desc_(is_desc),
       is_sorted_(false),
@@ -60,8 +61,6 @@ void SortExecutor::Init() {
 	else {
 		child_->Init();
 		SortBuffer();
-		//获取一项record
-		Next();
 	}
 }
 
@@ -70,8 +69,12 @@ void SortExecutor::Next() {
 		WSDB_STUDENT_TODO(L2, f1);
 	}
 	else {
-		record_ = std::move(sort_buffer_[buf_idx_]);
 		buf_idx_++;
+		if (buf_idx_ >= sort_buffer_.size()) {
+			sort_buffer_.clear();
+			arena_.Reset();
+			buf_idx_ = 0;
+		}
 	}
 }
 
@@ -80,18 +83,25 @@ auto SortExecutor::IsEnd() const -> bool {
 		WSDB_STUDENT_TODO(L2, f1);
 	}
 	else {
-		return (buf_idx_ > sort_buffer_.size() || record_ == nullptr);
+		return buf_idx_ >= sort_buffer_.size();
 	}
-	// buf_idx : 0
-	// rec_1, rec_2, rec_3
-	//
 }
 
-auto SortExecutor::Compare(const Record &lhs, const Record &rhs) const -> bool
+auto SortExecutor::HasRecord() const -> bool { return is_merge_sort_ ? record_ != nullptr : !IsEnd(); }
+
+auto SortExecutor::GetRecordView() const -> RecordView
+{
+  if (is_merge_sort_) {
+    return AbstractExecutor::GetRecordView();
+  }
+  WSDB_ASSERT(buf_idx_ < sort_buffer_.size(), "no current record");
+  return sort_buffer_[buf_idx_];
+}
+
+auto SortExecutor::Compare(const RecordView &lhs, const RecordView &rhs) const -> bool
 {
-  auto lkey = std::make_unique<Record>(key_schema_.get(), lhs);
-  auto rkey = std::make_unique<Record>(key_schema_.get(), rhs);
-  return is_desc_ ? Record::Compare(*lkey, *rkey) > 0 : lkey->Compare(*lkey, *rkey) < 0;
+  int cmp = comparator_.Compare(lhs, rhs);
+  return is_desc_ ? cmp > 0 : cmp < 0;
 }
 
 auto SortExecutor::GetOutSchema() const -> const RecordSchema * { return child_->GetOutSchema(); }
@@ -105,15 +115,16 @@ auto SortExecutor::GetSortFileName(size_t file_group, size_t file_idx) const ->
 
 void SortExecutor::SortBuffer()
 {
-	std::vector<RecordUptr> sortRecCtr;
+	sort_buffer_.clear();
+	arena_.Reset();
+	// copy the bytes of the child records into the arena instead of allocating a record for each of them
 	while (!child_->IsEnd()) {
-		sortRecCtr.push_back(child_->GetRecord());
+		sort_buffer_.push_back(arena_.Copy(child_->GetRecordView()));
 		child_->Next();
 	}
-	std::sort(sortRecCtr.begin(), sortRecCtr.end(), [this](const RecordUptr &lhs, const RecordUptr &rhs) {
-		return Compare(*lhs, *rhs);
+	std::sort(sort_buffer_.begin(), sort_buffer_.end(), [this](const RecordView &lhs, const RecordView &rhs) {
+		return Compare(lhs, rhs);
 	});
-	sort_buffer_ = std::move(sortRecCtr);
 	buf_idx_ = 0;
 }
 
@@ -30,6 +30,8 @@
 #include <fstream>
 #include <utility>
 #include "executor_abstract.h"
+#include "system/handle/record_arena.h"
+#include "system/handle/record_comparator.h"
 
 namespace wsdb {
 
@@ -46,6 +48,13 @@ public:
 
   [[nodiscard]] auto IsEnd() const -> bool override;
 
+  [[nodiscard]] auto HasRecord() const -> bool override;
+
+  /**
+   * The current record is a view into the sort buffer, it is valid until Next
+   */
+  [[nodiscard]] auto GetRecordView() const -> RecordView override;
+
   [[nodiscard]] auto GetOutSchema() const -> const RecordSchema * override;
 
 private:
@@ -119,7 +128,7 @@ private:
 private:
   [[nodiscard]] inline auto GetSortFileName(size_t file_group, size_t file_idx) const -> std::string;
 
-  [[nodiscard]] inline auto Compare(const Record &lhs, const Record &rhs) const -> bool;
+  [[nodiscard]] inline auto Compare(const RecordView &lhs, const RecordView &rhs) const -> bool;
 
   void SortBuffer();
 
@@ -132,7 +141,10 @@ private:
 private:
   AbstractExecutorUptr    child_;
   RecordSchemaUptr        key_schema_;
-  std::vector<RecordUptr> sort_buffer_;
+  RecordComparator        comparator_;  // compares child records on the fields of key_schema_
+  // records of the child copied into arena_, all released at once when the sort is done
+  RecordArena             arena_;
+  std::vector<RecordView> sort_buffer_;
   size_t                  buf_idx_;
   bool                    is_desc_;
   bool                    is_sorted_;
@@ -0,0 +1,43 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "buffer_access_strategy.h"
+#include <algorithm>
+#include "common/config.h"
+#include "buffer_pool_manager.h"
+
+namespace wsdb {
+
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, BufferAccessType type)
+    : buffer_pool_manager_(buffer_pool_manager), type_(type)
+{
+  size_t ring_size  = type == BufferAccessType::BULK_READ ? BULK_READ_RING_SIZE : BULK_WRITE_RING_SIZE;
+  size_t num_shards = buffer_pool_manager_->GetShardCount();
+  // pages are spread over the shards, so is the ring. never take more than 1/8 of a shard
+  size_t capacity = (ring_size + num_shards - 1) / num_shards;
+  capacity        = std::max<size_t>(std::min(capacity, buffer_pool_manager_->GetPoolSize() / num_shards / 8), 1);
+  rings_.resize(num_shards);
+  for (auto &ring : rings_) {
+    ring.capacity_ = capacity;
+    ring.frames_.reserve(capacity);
+  }
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() { buffer_pool_manager_->ReleaseRings(*this); }
+
+}  // namespace wsdb
@@ -0,0 +1,85 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_BUFFER_ACCESS_STRATEGY_H
+#define WSDB_BUFFER_ACCESS_STRATEGY_H
+
+#include <memory>
+#include <vector>
+#include "../../../common/micro.h"
+#include "common/types.h"
+
+namespace wsdb {
+
+class BufferPoolManager;
+
+enum class BufferAccessType
+{
+  BULK_READ,   // large sequential scans
+  BULK_WRITE,  // bulk loads, dirty pages are written back by the ring itself
+};
+
+// ring sizes in frames, shared by all shards of the buffer pool
+static constexpr size_t BULK_READ_RING_SIZE  = 32;
+static constexpr size_t BULK_WRITE_RING_SIZE = 128;
+
+/**
+ * Frames of one shard owned by a strategy, reused in round-robin order
+ */
+struct BufferRing
+{
+  std::vector<frame_id_t> frames_;
+  size_t                  next_{0};
+  size_t                  capacity_{0};
+};
+
+/**
+ * A buffer access strategy keeps the pages of a large scan or a bulk load inside a small ring of frames instead of
+ * the whole buffer pool. Pages fetched with a strategy do not enter the replacer, a frame of the ring is reused once
+ * the ring wraps around, so the hot pages of other queries are not flushed out of the pool. A page of the ring that
+ * is still pinned by someone else when the ring wraps around is handed over to the main pool.
+ * A strategy is used by a single thread, the frames return to the pool when it is destroyed.
+ */
+class BufferAccessStrategy
+{
+  friend class BufferPoolManager;
+
+public:
+  BufferAccessStrategy(BufferPoolManager *buffer_pool_manager, BufferAccessType type);
+
+  ~BufferAccessStrategy();
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(BufferAccessStrategy)
+
+  [[nodiscard]] auto GetType() const -> BufferAccessType { return type_; }
+
+  /** @return number of frames of the rings over all shards */
+  [[nodiscard]] auto GetRingSize() const -> size_t { return rings_.size() * rings_.front().capacity_; }
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  BufferAccessType   type_;
+  // one ring per shard, indexed by shard
+  std::vector<BufferRing> rings_;
+};
+
+DEFINE_UNIQUE_PTR(BufferAccessStrategy);
+
+}  // namespace wsdb
+
+#endif  // WSDB_BUFFER_ACCESS_STRATEGY_H
@@ -1,199 +1,516 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-#include "buffer_pool_manager.h"
-#include "replacer/lru_replacer.h"
-#include "replacer/lru_k_replacer.h"
-
-#include "../../../common/error.h"
-
-namespace wsdb {
-
-BufferPoolManager::BufferPoolManager(DiskManager *disk_manager, wsdb::LogManager *log_manager, size_t replacer_lru_k)
-    : disk_manager_(disk_manager), log_manager_(log_manager)
-{
-  if (REPLACER == "LRUReplacer") {
-    replacer_ = std::make_unique<LRUReplacer>();
-  } else if (REPLACER == "LRUKReplacer") {
-    replacer_ = std::make_unique<LRUKReplacer>(replacer_lru_k);
-  } else {
-    WSDB_FETAL("Unknown replacer: " + REPLACER);
-  }
-  // init free_list_
-	for (frame_id_t i = 0; i < static_cast<int>(BUFFER_POOL_SIZE); i++) {
-		free_list_.push_back(i);
-	}
-}
-
-auto BufferPoolManager::FetchPage(file_id_t fid, page_id_t pid) -> Page * {
-	std::lock_guard<std::mutex> lock(latch_);
-
-	auto page_lookup_key = fid_pid_t{fid, pid};
-
-	// 检查页面是否已经在缓冲池中
-	auto it = page_frame_lookup_.find(page_lookup_key);
-	// 页面不在缓冲池中
-	if (it == page_frame_lookup_.end()) {
-		frame_id_t frame_id = GetAvailableFrame();
-		UpdateFrame(frame_id, fid, pid);
-		return frames_[frame_id].GetPage();
-	}
-
-	frame_id_t frame_id = it->second;
-	Frame &frame = frames_[frame_id];
-	frame.Pin();
-	replacer_->Pin(frame_id);
-	return frame.GetPage();
-}
-
-auto BufferPoolManager::UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool
-{
-  std::lock_guard<std::mutex> lock(latch_);
-
-	auto it = page_frame_lookup_.find({fid, pid});
-	if (it == page_frame_lookup_.end()) {
-		return false;
-	}
-	frame_id_t frame_id = it->second;
-	Frame& frame = frames_[frame_id];
-	if (!frame.InUse()) {
-		return false;
-	}
-
-	frame.Unpin();
-	if (!frame.InUse()) {
-		replacer_->Unpin(frame_id);
-	}
-
-	if (is_dirty) {
-		frame.SetDirty(true);
-	}
-	return true;
-}
-
-auto BufferPoolManager::DeletePage(file_id_t fid, page_id_t pid) -> bool
-{
-	std::lock_guard<std::mutex> lock(latch_);
-	auto it = page_frame_lookup_.find({fid, pid});
-	if (it == page_frame_lookup_.end()) {
-		return true;
-	}
-	frame_id_t frame_id = it->second;
-	Frame &frame    = frames_[frame_id];
-	if (frame.InUse()) {
-		return false;
-	}
-	if (frame.IsDirty()) {
-		disk_manager_->WritePage(fid, pid, frame.GetPage()->GetData());
-	}
-	frame.Reset();
-	free_list_.push_back(frame_id);
-	replacer_->Unpin(frame_id);
-	page_frame_lookup_.erase(it);
-	// printf("Avaliable page : %ld\n", free_list_.size());
-	return true;
-}
-
-auto BufferPoolManager::DeleteAllPages(file_id_t fid) -> bool
-{
-	//std::lock_guard<std::mutex> lock(latch_);
-	bool all_deleted = true;
-	for (auto it = page_frame_lookup_.begin(); it != page_frame_lookup_.end();) {
-	if (it->first.fid == fid) {
-		auto next_it = std::next(it);
-		bool deleted = DeletePage(fid, it->first.pid);
-		if (!deleted) {
-			all_deleted = false;
-			break;
-		}
-			it = next_it;
-		} else {
-			++it;
-		}
-	}
-	return all_deleted;
-}
-
-auto BufferPoolManager::FlushPage(file_id_t fid, page_id_t pid) -> bool
-{
-	std::lock_guard<std::mutex> lock(latch_);
-	auto frame = GetFrame(fid, pid);
-	if (frame == nullptr) {
-		return false;
-	}
-	if (frame->IsDirty()) {
-		disk_manager_->WritePage(fid, pid, frame->GetPage()->GetData());  // 将脏页写入磁盘
-		frame->SetDirty(false);
-	}
-	return true;
-}
-
-auto BufferPoolManager::FlushAllPages(file_id_t fid) -> bool
-{
-	bool all_flushed = true;
-	for(auto it = page_frame_lookup_.begin(); it != page_frame_lookup_.end(); ++it) {
-		if (it->first.fid == fid) {
-			bool flushed = FlushPage(fid, it->first.pid);
-			if (!flushed) {
-				all_flushed = false;
-			}
-		}
-	}
-	return all_flushed;
-}
-
-auto BufferPoolManager::GetAvailableFrame() -> frame_id_t {
-	if (!free_list_.empty()) {
-		frame_id_t frame_id = free_list_.front();
-		free_list_.pop_front();
-		return frame_id;
-	}
-	frame_id_t frame_id;
-	if (replacer_->Victim(&frame_id)) {
-		return frame_id;
-	}
-	WSDB_THROW(WSDB_NO_FREE_FRAME, "error: no free frame");
-}
-
-void BufferPoolManager::UpdateFrame(frame_id_t frame_id, file_id_t fid, page_id_t pid) {
-	Frame &frame = frames_[frame_id];
-	Page  *page  = frame.GetPage();
-	if (frame.IsDirty()) {
-		disk_manager_->WritePage(page->GetTableId(), page->GetPageId(), frame.GetPage()->GetData());
-	}
-	page_frame_lookup_.erase({page->GetTableId(), page->GetPageId()});
-	frame.Reset();
-
-	disk_manager_->ReadPage(fid, pid, frame.GetPage()->GetData());
-	frame.GetPage()->SetTablePageId(fid, pid);
-
-	frame.Pin();
-	replacer_->Pin(frame_id);
-
-	page_frame_lookup_[{fid, pid}] = frame_id;
-}
-
-auto BufferPoolManager::GetFrame(file_id_t fid, page_id_t pid) -> Frame *
-{
-	const auto it = page_frame_lookup_.find({fid, pid});
-	return it == page_frame_lookup_.end() ? nullptr : &frames_[it->second];
-}
-
-}  // namespace wsdb
\ No newline at end of file
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+//
+// Created by ziqi on 2024/7/17.
+//
+#include "buffer_pool_manager.h"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "../../../common/error.h"
+
+namespace wsdb {
+
+BufferPoolManager::BufferPoolManager(
+    DiskManager *disk_manager, wsdb::LogManager *log_manager, size_t replacer_lru_k, size_t num_shards,
+    const std::string &replacer, size_t pool_size)
+    : disk_manager_(disk_manager), log_manager_(log_manager), pool_size_(std::max<size_t>(pool_size, 1))
+{
+  pages_ = std::make_unique<PageRegion>(pool_size_);
+  // every shard needs at least one frame
+  num_shards = std::clamp<size_t>(num_shards, 1, pool_size_);
+  shards_.reserve(num_shards);
+  size_t first_page = 0;
+  for (size_t i = 0; i < num_shards; i++) {
+    // spread the remainder over the first shards
+    size_t shard_size = pool_size_ / num_shards + (i < pool_size_ % num_shards ? 1 : 0);
+    shards_.push_back(std::make_unique<BufferPoolShard>(
+        disk_manager, log_manager, pages_->GetPage(first_page), shard_size, replacer, replacer_lru_k));
+    first_page += shard_size;
+  }
+}
+
+BufferPoolManager::~BufferPoolManager()
+{
+  StopReadAhead();
+  StopPageCleaner();
+}
+
+auto BufferPoolManager::FetchPage(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> Page *
+{
+  return FetchFrame(fid, pid, strategy)->GetPage();
+}
+
+auto BufferPoolManager::FetchPageRead(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> ReadPageGuard
+{
+  return {this, fid, pid, FetchFrame(fid, pid, strategy)};
+}
+
+auto BufferPoolManager::FetchPageWrite(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> WritePageGuard
+{
+  return {this, fid, pid, FetchFrame(fid, pid, strategy)};
+}
+
+auto BufferPoolManager::NewPage(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> WritePageGuard
+{
+  size_t idx = GetShardIndex(fid, pid);
+  return {this, fid, pid,
+      shards_[idx]->FetchFrame(fid, pid, strategy == nullptr ? nullptr : &strategy->rings_[idx], false)};
+}
+
+auto BufferPoolManager::FetchFrame(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> Frame *
+{
+  size_t idx   = GetShardIndex(fid, pid);
+  Frame *frame = shards_[idx]->FetchFrame(fid, pid, strategy == nullptr ? nullptr : &strategy->rings_[idx]);
+  if (readahead_max_pages_.load(std::memory_order_relaxed) != 0) {
+    ReadAhead(fid, pid, strategy);
+  }
+  return frame;
+}
+
+auto BufferPoolManager::UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool
+{
+  return GetShard(fid, pid).UnpinPage(fid, pid, is_dirty);
+}
+
+auto BufferPoolManager::DeletePage(file_id_t fid, page_id_t pid) -> bool
+{
+  return GetShard(fid, pid).DeletePage(fid, pid);
+}
+
+auto BufferPoolManager::DeleteAllPages(file_id_t fid) -> bool
+{
+  WaitReadAhead(fid);
+  {
+    // the file id may be reused by another file
+    auto                       &stripe = GetReadAheadStripe(fid);
+    std::lock_guard<std::mutex> lock(stripe.latch_);
+    stripe.states_.erase(fid);
+  }
+  bool all_deleted = true;
+  for (auto &shard : shards_) {
+    if (!shard->DeleteAllPages(fid)) {
+      all_deleted = false;
+    }
+  }
+  return all_deleted;
+}
+
+auto BufferPoolManager::FlushPage(file_id_t fid, page_id_t pid) -> bool
+{
+  return GetShard(fid, pid).FlushPage(fid, pid);
+}
+
+auto BufferPoolManager::FlushAllPages(file_id_t fid) -> bool
+{
+  WaitReadAhead(fid);
+  // pin at most a quarter of every shard at once, the rest of the pool stays available to other queries
+  size_t    max_pages   = std::max<size_t>(pool_size_ / shards_.size() / 4, 1);
+  page_id_t first_pid   = 0;
+  bool      all_flushed = true;
+  while (true) {
+    std::vector<std::vector<FlushEntry>> shard_batches(shards_.size());
+    std::vector<FlushEntry *>            batch;
+    // pages from next_pid on are left in a shard that reached max_pages, they go to the next batch
+    page_id_t next_pid = std::numeric_limits<page_id_t>::max();
+    for (size_t i = 0; i < shards_.size(); i++) {
+      shard_batches[i] = shards_[i]->BeginFlush(fid, first_pid, max_pages);
+      if (shard_batches[i].size() == max_pages) {
+        next_pid = std::min(next_pid, shard_batches[i].back().pid_ + 1);
+      }
+      for (auto &entry : shard_batches[i]) {
+        batch.push_back(&entry);
+      }
+    }
+    std::sort(batch.begin(), batch.end(), [](const FlushEntry *a, const FlushEntry *b) { return a->pid_ < b->pid_; });
+    WriteFlushBatch(fid, batch);
+    for (size_t i = 0; i < shards_.size(); i++) {
+      all_flushed = all_flushed && std::all_of(shard_batches[i].begin(), shard_batches[i].end(),
+                                       [](const FlushEntry &entry) { return entry.written_; });
+      shards_[i]->EndFlush(shard_batches[i]);
+    }
+    if (next_pid == std::numeric_limits<page_id_t>::max()) {
+      break;
+    }
+    first_pid = next_pid;
+  }
+  return all_flushed;
+}
+
+void BufferPoolManager::WriteFlushBatch(file_id_t fid, const std::vector<FlushEntry *> &batch)
+{
+  // runs being written, [first, end) of the batch with the ticket of the write, their pages stay latched until done
+  std::vector<std::tuple<io_ticket_t, size_t, size_t>> in_flight;
+  auto                                                  wait_runs = [&]() {
+    for (auto [ticket, first, end] : in_flight) {
+      try {
+        disk_manager_->WaitIO(ticket);
+        for (size_t i = first; i < end; i++) {
+          batch[i]->written_ = true;
+        }
+      } catch (WSDBException_ &e) {
+        WSDB_LOG_ERROR(e.what());
+      }
+      for (size_t i = first; i < end; i++) {
+        batch[i]->frame_->GetLatch().unlock_shared();
+      }
+    }
+    in_flight.clear();
+  };
+
+  std::vector<const char *> run;
+  for (size_t first = 0, end = 0; first < batch.size(); first = end) {
+    // a writer holding the page must finish first, see BufferPoolShard::FlushPage. Only the first page of a run
+    // waits for its latch, and only when no other run is in flight, waiting with latches held could deadlock with a
+    // thread holding several pages
+    if (!batch[first]->frame_->GetLatch().try_lock_shared()) {
+      wait_runs();
+      batch[first]->frame_->GetLatch().lock_shared();
+    }
+    for (end = first + 1; end < batch.size(); end++) {
+      if (batch[end]->pid_ != batch[end - 1]->pid_ + 1 || !batch[end]->frame_->GetLatch().try_lock_shared()) {
+        break;
+      }
+    }
+    run.clear();
+    for (size_t i = first; i < end; i++) {
+      run.push_back(batch[i]->frame_->GetPage()->GetData());
+    }
+    // the pages are latched, the records of their changes are all logged
+    FlushLog();
+    in_flight.emplace_back(disk_manager_->SubmitWritePages(fid, batch[first]->pid_, run), first, end);
+  }
+  wait_runs();
+}
+
+auto BufferPoolManager::GetFrame(file_id_t fid, page_id_t pid) -> Frame *
+{
+  return GetShard(fid, pid).GetFrame(fid, pid);
+}
+
+auto BufferPoolManager::GetShardIndex(file_id_t fid, page_id_t pid) const -> size_t
+{
+  if (shards_.size() == 1) {
+    return 0;
+  }
+  // fibonacci hashing on the packed key, consecutive pages of a file land in different shards
+  auto key = fid_pid_t{fid, pid}.Pack() * 0x9E3779B97F4A7C15ULL;
+  return (key >> 32) % shards_.size();
+}
+
+void BufferPoolManager::StartPageCleaner(size_t pages_per_round, std::chrono::milliseconds interval)
+{
+  StopPageCleaner();
+  cleaner_stop_ = false;
+  cleaner_      = std::thread(&BufferPoolManager::PageCleanerLoop, this, pages_per_round, interval);
+}
+
+void BufferPoolManager::StopPageCleaner()
+{
+  if (!cleaner_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(cleaner_latch_);
+    cleaner_stop_ = true;
+  }
+  cleaner_cv_.notify_all();
+  cleaner_.join();
+}
+
+auto BufferPoolManager::GetStats() -> BufferPoolStats
+{
+  BufferPoolStats stats;
+  for (auto &shard : shards_) {
+    auto shard_stats = shard->GetStats();
+    stats.evictions_ += shard_stats.evictions_;
+    stats.sync_writes_ += shard_stats.sync_writes_;
+    stats.cleaner_writes_ += shard_stats.cleaner_writes_;
+  }
+  return stats;
+}
+
+void BufferPoolManager::PageCleanerLoop(size_t pages_per_round, std::chrono::milliseconds interval)
+{
+  // the budget is shared by the shards, a shard gets at least one page per round
+  size_t pages_per_shard = std::max<size_t>(pages_per_round / shards_.size(), 1);
+  std::unique_lock<std::mutex> lock(cleaner_latch_);
+  while (!cleaner_cv_.wait_for(lock, interval, [this] { return cleaner_stop_; })) {
+    lock.unlock();
+    for (auto &shard : shards_) {
+      try {
+        shard->CleanPages(pages_per_shard);
+      } catch (WSDBException_ &e) {
+        WSDB_LOG_ERROR(e.what());
+      }
+    }
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::StartReadAhead(size_t max_pages)
+{
+  StopReadAhead();
+  // read-ahead pins its frames until the read finishes, keep it well below the pool size
+  max_pages = std::min(max_pages, pool_size_ / 8);
+  if (max_pages == 0) {
+    return;
+  }
+  readahead_stop_   = false;
+  readahead_worker_ = std::thread(&BufferPoolManager::ReadAheadLoop, this);
+  readahead_max_pages_.store(max_pages);
+}
+
+void BufferPoolManager::StopReadAhead()
+{
+  if (!readahead_worker_.joinable()) {
+    return;
+  }
+  readahead_max_pages_.store(0);
+  {
+    std::lock_guard<std::mutex> lock(readahead_queue_latch_);
+    readahead_stop_ = true;
+  }
+  readahead_queue_cv_.notify_all();
+  readahead_worker_.join();
+  for (auto &stripe : readahead_stripes_) {
+    std::lock_guard<std::mutex> lock(stripe.latch_);
+    stripe.states_.clear();
+  }
+}
+
+void BufferPoolManager::ReadAhead(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy)
+{
+  auto     &stripe = GetReadAheadStripe(fid);
+  page_id_t start_pid;
+  size_t    window;
+  {
+    std::lock_guard<std::mutex> lock(stripe.latch_);
+    auto                       &ra = stripe.states_[fid];
+    if (pid == ra.last_pid_) {
+      // the same page again, e.g. GetNextRID then GetRecord
+      return;
+    }
+    bool sequential = ra.last_pid_ != INVALID_PAGE_ID && pid == ra.last_pid_ + 1;
+    ra.last_pid_    = pid;
+    if (!sequential) {
+      ra.window_ = 0;
+      return;
+    }
+    size_t max_window = readahead_max_pages_.load();
+    if (strategy != nullptr) {
+      // leave half of the ring to the pages being consumed, otherwise the ring recycles pages not read yet
+      max_window = std::min(max_window, std::max<size_t>(strategy->GetRingSize() / 2, 1));
+    }
+    if (ra.window_ == 0) {
+      window    = std::min(READ_AHEAD_MIN_PAGES, max_window);
+      start_pid = pid + 1;
+    } else if (pid < ra.trigger_pid_) {
+      return;
+    } else {
+      window    = std::min(ra.window_ * 2, max_window);
+      start_pid = std::max(ra.next_pid_, pid + 1);
+    }
+    ra.window_      = window;
+    ra.trigger_pid_ = start_pid;
+    ra.next_pid_    = start_pid + static_cast<page_id_t>(window);
+    ra.pending_++;
+  }
+
+  // claim the frames in the fetching thread, the rings of the strategy must not be touched by others
+  ReadAheadRequest request{fid, start_pid, {}};
+  bool             claimed   = false;
+  page_id_t        file_size = 0;
+  try {
+    file_size = static_cast<page_id_t>(disk_manager_->GetFilePageCount(fid));
+  } catch (WSDBException_ &e) {
+    // the file is being closed, nothing to read
+  }
+  for (page_id_t p = start_pid; p < start_pid + static_cast<page_id_t>(window) && p < file_size; p++) {
+    size_t idx   = GetShardIndex(fid, p);
+    auto   claim = shards_[idx]->ClaimForReadAhead(fid, p, strategy == nullptr ? nullptr : &strategy->rings_[idx]);
+    claimed |= claim.has_value();
+    request.claims_.emplace_back(shards_[idx].get(), claim);
+  }
+  if (claimed) {
+    std::lock_guard<std::mutex> lock(readahead_queue_latch_);
+    if (!readahead_stop_) {
+      readahead_queue_.push_back(std::move(request));
+      readahead_queue_cv_.notify_one();
+      return;
+    }
+  }
+  // nothing to read, or the worker has stopped meanwhile
+  for (auto &[shard, claim] : request.claims_) {
+    if (claim.has_value()) {
+      shard->FinishReadAhead(*claim, false);
+    }
+  }
+  std::lock_guard<std::mutex> lock(stripe.latch_);
+  stripe.states_[fid].pending_--;
+  stripe.cv_.notify_all();
+}
+
+void BufferPoolManager::WaitReadAhead(file_id_t fid)
+{
+  auto                        &stripe = GetReadAheadStripe(fid);
+  std::unique_lock<std::mutex> lock(stripe.latch_);
+  stripe.cv_.wait(lock, [&stripe, fid] {
+    auto it = stripe.states_.find(fid);
+    return it == stripe.states_.end() || it->second.pending_ == 0;
+  });
+}
+
+void BufferPoolManager::ReadAheadLoop()
+{
+  std::unique_lock<std::mutex> lock(readahead_queue_latch_);
+  while (true) {
+    readahead_queue_cv_.wait(lock, [this] { return readahead_stop_ || !readahead_queue_.empty(); });
+    if (readahead_queue_.empty()) {
+      // stopped, the pending requests are all done
+      return;
+    }
+    ReadAheadRequest request = std::move(readahead_queue_.front());
+    readahead_queue_.pop_front();
+    lock.unlock();
+
+    LoadClaims(request.fid_, request.claims_);
+    {
+      auto                       &stripe = GetReadAheadStripe(request.fid_);
+      std::lock_guard<std::mutex> stripe_lock(stripe.latch_);
+      stripe.states_[request.fid_].pending_--;
+      stripe.cv_.notify_all();
+    }
+    lock.lock();
+  }
+}
+
+auto BufferPoolManager::GetDirtyPages() -> std::vector<fid_pid_t>
+{
+  std::vector<fid_pid_t> pages;
+  for (auto &shard : shards_) {
+    auto shard_pages = shard->GetDirtyPages();
+    pages.insert(pages.end(), shard_pages.begin(), shard_pages.end());
+  }
+  return pages;
+}
+
+auto BufferPoolManager::Checkpoint() -> CheckpointInfo
+{
+  CheckpointInfo info;
+  info.dirty_pages_ = GetDirtyPages();
+  info.complete_    = true;
+
+  auto pages = info.dirty_pages_;
+  std::sort(pages.begin(), pages.end(), [](const fid_pid_t &a, const fid_pid_t &b) { return a.Pack() < b.Pack(); });
+  // pin at most a quarter of every shard at once like FlushAllPages, a batch ends when one of its shards is full
+  size_t max_pages = std::max<size_t>(pool_size_ / shards_.size() / 4, 1);
+  for (size_t first = 0, end = 0; first < pages.size(); first = end) {
+    file_id_t                           fid = pages[first].fid;
+    std::vector<std::vector<page_id_t>> shard_pids(shards_.size());
+    for (end = first; end < pages.size() && pages[end].fid == fid; end++) {
+      auto &pids = shard_pids[GetShardIndex(fid, pages[end].pid)];
+      if (pids.size() == max_pages) {
+        break;
+      }
+      pids.push_back(pages[end].pid);
+    }
+    std::vector<std::vector<FlushEntry>> shard_batches(shards_.size());
+    std::vector<FlushEntry *>            batch;
+    for (size_t i = 0; i < shards_.size(); i++) {
+      if (shard_pids[i].empty()) {
+        continue;
+      }
+      shard_batches[i] = shards_[i]->BeginFlush(fid, shard_pids[i]);
+      for (auto &entry : shard_batches[i]) {
+        batch.push_back(&entry);
+      }
+    }
+    std::sort(batch.begin(), batch.end(), [](const FlushEntry *a, const FlushEntry *b) { return a->pid_ < b->pid_; });
+    WriteFlushBatch(fid, batch);
+    for (size_t i = 0; i < shards_.size(); i++) {
+      info.complete_ = info.complete_ && std::all_of(shard_batches[i].begin(), shard_batches[i].end(),
+                                             [](const FlushEntry &entry) { return entry.written_; });
+      shards_[i]->EndFlush(shard_batches[i]);
+    }
+  }
+  return info;
+}
+
+void BufferPoolManager::FlushLog()
+{
+  if (log_manager_ != nullptr) {
+    log_manager_->FlushLog();
+  }
+}
+
+void BufferPoolManager::LoadClaims(file_id_t fid, std::vector<ShardClaim> &claims)
+{
+  // write back the dirty victims, a claim whose victim can not be written is given up
+  for (auto &[shard, claim] : claims) {
+    if (!claim.has_value()) {
+      continue;
+    }
+    try {
+      shard->WriteVictim(*claim);
+    } catch (WSDBException_ &e) {
+      shard->FinishReadAhead(*claim, false);
+      claim.reset();
+    }
+  }
+  // one vectored read for each run of consecutive claimed pages, all runs are in flight at the same time
+  std::vector<std::tuple<io_ticket_t, size_t, size_t>> reads;
+  for (size_t i = 0; i < claims.size();) {
+    if (!claims[i].second.has_value()) {
+      i++;
+      continue;
+    }
+    page_id_t           start_pid = claims[i].second->page_.pid;
+    size_t              j         = i;
+    std::vector<char *> pages;
+    for (; j < claims.size() && claims[j].second.has_value() &&
+           claims[j].second->page_.pid == start_pid + static_cast<page_id_t>(j - i);
+         j++) {
+      pages.push_back(claims[j].first->GetClaimedData(*claims[j].second));
+    }
+    reads.emplace_back(disk_manager_->SubmitReadPages(fid, start_pid, pages), i, j);
+    i = j;
+  }
+  for (auto [ticket, first, end] : reads) {
+    bool loaded = true;
+    try {
+      disk_manager_->WaitIO(ticket);
+    } catch (WSDBException_ &e) {
+      loaded = false;
+    }
+    for (size_t i = first; i < end; i++) {
+      claims[i].first->FinishReadAhead(*claims[i].second, loaded);
+    }
+  }
+}
+
+void BufferPoolManager::ReleaseRings(BufferAccessStrategy &strategy)
+{
+  for (size_t i = 0; i < shards_.size(); i++) {
+    shards_[i]->ReleaseRing(strategy.rings_[i]);
+  }
+}
+
+}  // namespace wsdb
@@ -1,172 +1,326 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#ifndef WSDB_BUFFER_POOL_MANAGER_H
-#define WSDB_BUFFER_POOL_MANAGER_H
-
-#include <list>
-#include <memory>
-#include <mutex>  // NOLINT
-#include <vector>
-#include <array>
-#include "storage/disk/disk_manager.h"
-#include "log/log_manager.h"
-#include "replacer/replacer.h"
-#include "frame.h"
-#include "common/page.h"
-
-namespace wsdb {
-struct fid_pid_t
-{
-  file_id_t fid;
-  page_id_t pid;
-
-  bool operator==(const fid_pid_t &rhs) const { return fid == rhs.fid && pid == rhs.pid; }
-};
-}  // namespace wsdb
-
-namespace std {
-template <>
-struct hash<wsdb::fid_pid_t>
-{
-  size_t operator()(const wsdb::fid_pid_t &fp) const
-  {
-    return std::hash<table_id_t>()(fp.fid) ^ std::hash<frame_id_t>()(fp.pid);
-  }
-};
-}  // namespace std
-
-namespace wsdb {
-
-class BufferPoolManager
-{
-public:
-  explicit BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager = nullptr, size_t replacer_lru_k = 0);
-
-  ~BufferPoolManager() = default;
-
-  DISABLE_COPY_MOVE_AND_ASSIGN(BufferPoolManager)
-
-  /**
-   * Fetch the requested page from disk.
-   * 1. grant the latch
-   * 2. check if the page is in the frame
-   * 3. if the page is not in the frame, GetAvailableFrame and UpdateFrame
-   * 4. else pin the frame both in the buffer and the replacer and return the page
-   * @param fid file that the page belongs to
-   * @param pid page id
-   * @return the page
-   */
-  auto FetchPage(file_id_t fid, page_id_t pid) -> Page *;
-
-  /**
-   * Unpin the page indicating that it can be victimized
-   * 1. grant the latch
-   * 2. if the frame is not in the buffer or the frame is not in use, return false
-   * 3. unpin the frame, after that if the frame is not in use, unpin the frame in the replacer
-   * 4. set the frame dirty if the page is dirty
-   * @param fid
-   * @param pid
-   * @param is_dirty
-   * @return true if the page is unpinned successfully
-   */
-  auto UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool;
-
-  /**
-   * Delete the page from the buffer pool
-   * 1. grant the latch
-   * 2. if the page is not in the buffer, return true
-   * 3. if the page is in use, return false
-   * 4. flush the page to disk, reset the frame, add the frame to the free list and unpin the frame in the replacer
-   * 5. update the page_frame_lookup_
-   * @param fid
-   * @param pid
-   * @return true if the page is deleted successfully
-   */
-  auto DeletePage(file_id_t fid, page_id_t pid) -> bool;
-
-  /**
-   * Delete all pages belong to the file
-   * @param fid
-   * @return true if all pages are deleted successfully
-   */
-  auto DeleteAllPages(file_id_t fid) -> bool;
-
-  /**
-   * Flush the page to disk
-   * 1. grant the latch
-   * 2. if the page is not in the buffer, return false
-   * 3. flush the page to disk if the page is dirty
-   * @param fid
-   * @param pid
-   * @return true if the page is flushed successfully
-   */
-  auto FlushPage(file_id_t fid, page_id_t pid) -> bool;
-
-  /**
-   * Flush all pages to disk
-   * @param fid
-   * @return
-   */
-  auto FlushAllPages(file_id_t fid) -> bool;
-
-  /**
-   * Get the frame, used for test
-   */
-  auto GetFrame(file_id_t fid, page_id_t pid) -> Frame *;
-
-private:
-  /// sub procedures used by public APIs, should not be locked by latch
-
-  /**
-   * Get the available frame
-   * 1. if the free list is not empty, get the frame id from the free list
-   * 2. else use the replacer to get the frame id
-   * 3. if no frame can be evicted, throw WSDB_NO_FREE_FRAME
-   * @return the frame id
-   */
-  auto GetAvailableFrame() -> frame_id_t;
-
-  /**
-   * Update the frame
-   * 1. if the frame is dirty, flush the page to disk
-   * 2. update the frame with the new page
-   * 3. pin the frame in the buffer and the replacer
-   * 4. update the page_frame_lookup_
-   * @param frame_id the frame to update
-   * @param fid the file needs to be updated to the frame
-   * @param pid the page needs to be updated to the frame
-   */
-  void UpdateFrame(frame_id_t frame_id, file_id_t fid, page_id_t pid);
-
-private:
-  std::mutex                                latch_;
-  DiskManager                              *disk_manager_;
-  LogManager                               *log_manager_;
-  std::unique_ptr<Replacer>                 replacer_;
-  std::array<Frame, BUFFER_POOL_SIZE>       frames_;
-  std::list<frame_id_t>                     free_list_;
-  std::unordered_map<fid_pid_t, frame_id_t> page_frame_lookup_;
-};
-
-}  // namespace wsdb
-
-#endif  // WSDB_BUFFER_POOL_MANAGER_H
\ No newline at end of file
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#ifndef WSDB_BUFFER_POOL_MANAGER_H
+#define WSDB_BUFFER_POOL_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+#include "buffer_pool_shard.h"
+#include "page_guard.h"
+#include "page_region.h"
+
+namespace wsdb {
+
+// the first read-ahead window of a sequentially read file
+static constexpr size_t READ_AHEAD_MIN_PAGES = 4;
+static constexpr size_t READ_AHEAD_STRIPES   = 16;
+
+/**
+ * Result of BufferPoolManager::Checkpoint
+ */
+struct CheckpointInfo
+{
+  std::vector<fid_pid_t> dirty_pages_;      // the dirty page table taken at the start of the checkpoint
+  bool                   complete_{false};  // every page of dirty_pages_ has been written since then
+};
+
+/**
+ * The buffer pool is partitioned into several independent shards, a page always lives in the shard chosen by hashing
+ * its (fid, pid), so page hits in different shards never share a latch. With a single shard the behavior is the same
+ * as a plain global buffer pool.
+ */
+class BufferPoolManager
+{
+public:
+  /**
+   * @param disk_manager
+   * @param log_manager
+   * @param replacer_lru_k k used by LRUKReplacer
+   * @param num_shards number of shards, the frames are evenly divided among the shards
+   * @param replacer replacement policy of every shard: LRUReplacer, LRUKReplacer, ClockReplacer or TwoQueueReplacer
+   * @param pool_size number of frames of the whole pool, the pages are allocated in one PageRegion
+   */
+  explicit BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager = nullptr, size_t replacer_lru_k = 0,
+      size_t num_shards = 1, const std::string &replacer = REPLACER, size_t pool_size = BUFFER_POOL_SIZE);
+
+  ~BufferPoolManager();
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(BufferPoolManager)
+
+  /**
+   * Fetch the requested page from the shard it belongs to, see BufferPoolShard::FetchFrame.
+   * The page is only pinned, prefer FetchPageRead and FetchPageWrite that also latch and unpin it
+   * @param fid file that the page belongs to
+   * @param pid page id
+   * @param strategy buffer access strategy of large scans and bulk loads, nullptr for normal accesses
+   * @return the page
+   */
+  auto FetchPage(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy = nullptr) -> Page *;
+
+  /**
+   * Fetch the page and take its shared latch, the page is unpinned when the guard is dropped
+   * @param fid
+   * @param pid
+   * @param strategy
+   * @return the guard
+   */
+  auto FetchPageRead(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy = nullptr) -> ReadPageGuard;
+
+  /**
+   * Fetch the page and take its exclusive latch, the page is unpinned dirty when the guard is dropped
+   * @param fid
+   * @param pid
+   * @param strategy
+   * @return the guard
+   */
+  auto FetchPageWrite(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy = nullptr) -> WritePageGuard;
+
+  /**
+   * Get a zero-filled frame for a page appended to the file, the page is not read from disk as it is not there yet.
+   * If the page is already in the buffer pool it is returned as it is, like FetchPageWrite
+   * @param fid
+   * @param pid
+   * @param strategy
+   * @return the guard holding the exclusive latch, the page is unpinned dirty when the guard is dropped
+   */
+  auto NewPage(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy = nullptr) -> WritePageGuard;
+
+  /**
+   * Unpin the page indicating that it can be victimized, see BufferPoolShard::UnpinPage
+   * @param fid
+   * @param pid
+   * @param is_dirty
+   * @return true if the page is unpinned successfully
+   */
+  auto UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool;
+
+  /**
+   * Delete the page from the buffer pool, see BufferPoolShard::DeletePage
+   * @param fid
+   * @param pid
+   * @return true if the page is deleted successfully
+   */
+  auto DeletePage(file_id_t fid, page_id_t pid) -> bool;
+
+  /**
+   * Delete all pages belong to the file, see BufferPoolShard::DeleteAllPages. A shard keeps all pages of the file if
+   * one of them is in use, the other shards still drop theirs, which are written back first so nothing is lost
+   * @param fid
+   * @return true if all pages are deleted successfully
+   */
+  auto DeleteAllPages(file_id_t fid) -> bool;
+
+  /**
+   * Flush the page to disk, see BufferPoolShard::FlushPage
+   * @param fid
+   * @param pid
+   * @return true if the page is flushed successfully
+   */
+  auto FlushPage(file_id_t fid, page_id_t pid) -> bool;
+
+  /**
+   * Flush all pages of the file to disk. The dirty pages of all shards are collected by BufferPoolShard::BeginFlush
+   * and written as one batch in page order, only the pages of the file are visited
+   * @param fid
+   * @return true if all pages are flushed successfully
+   */
+  auto FlushAllPages(file_id_t fid) -> bool;
+
+  /**
+   * Get the frame, used for test
+   */
+  auto GetFrame(file_id_t fid, page_id_t pid) -> Frame *;
+
+  [[nodiscard]] auto GetShardCount() const -> size_t { return shards_.size(); }
+
+  [[nodiscard]] auto GetPoolSize() const -> size_t { return pool_size_; }
+
+  /**
+   * Start the background page cleaner, it wakes up every interval and writes back the dirty pages that are next to be
+   * evicted in every shard, so that queries rarely have to write a dirty victim themselves
+   * @param pages_per_round I/O budget, maximum number of pages written in one round over the whole pool
+   * @param interval time between two rounds
+   */
+  void StartPageCleaner(size_t pages_per_round, std::chrono::milliseconds interval);
+
+  /**
+   * Stop the page cleaner and wait for the running round to finish, it is also stopped when the pool is destroyed
+   */
+  void StopPageCleaner();
+
+  /**
+   * Start read-ahead, when a file is fetched at consecutive page ids, the following pages are read by a background
+   * worker with vectored reads. The window starts at READ_AHEAD_MIN_PAGES and doubles every time the fetches reach the
+   * previous window, up to max_pages
+   * @param max_pages maximum number of pages read ahead at once
+   */
+  void StartReadAhead(size_t max_pages);
+
+  /**
+   * Stop read-ahead and wait for the pending reads, it is also stopped when the pool is destroyed
+   */
+  void StopReadAhead();
+
+  /**
+   * Get the dirty page table, the pages that may hold changes not on disk yet, see BufferPoolShard::GetDirtyPages.
+   * The shards are visited one after another, a page modified after its shard is visited may be missing
+   * @return
+   */
+  auto GetDirtyPages() -> std::vector<fid_pid_t>;
+
+  /**
+   * Take a fuzzy checkpoint, fetches and modifications go on during it
+   * 1. take the dirty page table with GetDirtyPages, a page changed before the call is either in the table or on disk
+   * 2. write only the pages of the table, in batches of page order per file with BufferPoolShard::BeginFlush, pages
+   * dirtied after the table was taken are left to the page cleaner
+   * 3. the log manager is flushed before each write (write-ahead logging), like every other page write of the pool
+   * @return the dirty page table. If complete_, every change made before the call is on disk, so the log manager may
+   * move its redo start point to its log position at the call
+   */
+  auto Checkpoint() -> CheckpointInfo;
+
+  /**
+   * @return counters summed over all shards, compare sync_writes_ with evictions_ to see how well the cleaner works
+   */
+  auto GetStats() -> BufferPoolStats;
+
+private:
+  friend class BufferAccessStrategy;
+
+  /**
+   * Get the index of the shard that the page belongs to
+   */
+  auto GetShardIndex(file_id_t fid, page_id_t pid) const -> size_t;
+
+  auto GetShard(file_id_t fid, page_id_t pid) -> BufferPoolShard & { return *shards_[GetShardIndex(fid, pid)]; }
+
+  /**
+   * Return the frames of all rings of the strategy to their shards, called when the strategy is destroyed
+   */
+  void ReleaseRings(BufferAccessStrategy &strategy);
+
+  /**
+   * Fetch the page from its shard and trigger read-ahead, returns the pinned frame
+   */
+  auto FetchFrame(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy) -> Frame *;
+
+  void PageCleanerLoop(size_t pages_per_round, std::chrono::milliseconds interval);
+
+  /**
+   * Track the fetch of a page, and if the file is read sequentially, claim frames for the next window and hand them
+   * to the read-ahead worker. Claims use the rings of the strategy so that read-ahead of a large scan stays in its ring
+   */
+  void ReadAhead(file_id_t fid, page_id_t pid, BufferAccessStrategy *strategy);
+
+  /**
+   * Wait until no read-ahead of the file is pending, e.g. before flushing or dropping its pages
+   */
+  void WaitReadAhead(file_id_t fid);
+
+  void ReadAheadLoop();
+
+  // a frame claimed in a shard for a page to be loaded, nullopt if the page needs no read
+  using ShardClaim = std::pair<BufferPoolShard *, std::optional<FrameClaim>>;
+
+  /**
+   * Load the claimed pages of a file and finish the claims, claims_[i] are ordered by page id. Dirty victims are
+   * written back first, a claim whose victim can not be written is given up. Runs of consecutive page ids are read by
+   * one DiskManager::SubmitReadPages, all runs in flight together
+   */
+  void LoadClaims(file_id_t fid, std::vector<ShardClaim> &claims);
+
+  /**
+   * Write the pages of a flush batch sorted by page id, and mark those written. Runs of consecutive pages are written
+   * by one DiskManager::SubmitWritePages, the runs are in flight together and each page stays under its shared latch
+   * until its run is written
+   */
+  void WriteFlushBatch(file_id_t fid, const std::vector<FlushEntry *> &batch);
+
+  /**
+   * Flush the log manager before writing pages, the writers of the pages have logged their changes before releasing
+   * the page latch, does nothing without a log manager
+   */
+  void FlushLog();
+
+private:
+  DiskManager                                  *disk_manager_;
+  LogManager                                   *log_manager_;
+  size_t                                        pool_size_;
+  PageRegionUptr                                pages_;  // must outlive the shards
+  std::vector<std::unique_ptr<BufferPoolShard>> shards_;
+
+  std::thread             cleaner_;
+  std::mutex              cleaner_latch_;
+  std::condition_variable cleaner_cv_;
+  bool                    cleaner_stop_{false};
+
+  struct ReadAheadState
+  {
+    page_id_t last_pid_{INVALID_PAGE_ID};     // last page fetched
+    page_id_t next_pid_{INVALID_PAGE_ID};     // first page not read ahead yet
+    page_id_t trigger_pid_{INVALID_PAGE_ID};  // the next window is read when the fetches reach this page
+    size_t    window_{0};                     // size of the last window, 0 if the file is not read sequentially
+    size_t    pending_{0};                    // requests of the file not finished by the worker
+  };
+
+  // every fetch updates the state of its file, the states are striped by file so that fetches of different files do
+  // not share a latch
+  struct ReadAheadStripe
+  {
+    std::mutex                                    latch_;
+    std::condition_variable                       cv_;  // notified when a request of the stripe finishes
+    std::unordered_map<file_id_t, ReadAheadState> states_;
+  };
+
+  struct ReadAheadRequest
+  {
+    file_id_t fid_;
+    page_id_t start_pid_;
+    // claims_[i] is for page start_pid_ + i
+    std::vector<ShardClaim> claims_;
+  };
+
+  auto GetReadAheadStripe(file_id_t fid) -> ReadAheadStripe &
+  {
+    return readahead_stripes_[static_cast<size_t>(fid) % READ_AHEAD_STRIPES];
+  }
+
+  std::array<ReadAheadStripe, READ_AHEAD_STRIPES> readahead_stripes_;
+  std::atomic<size_t>                             readahead_max_pages_{0};  // 0 if read-ahead is off
+  std::thread                                     readahead_worker_;
+  std::mutex                                      readahead_queue_latch_;
+  std::condition_variable                         readahead_queue_cv_;
+  std::deque<ReadAheadRequest>                    readahead_queue_;
+  bool                                            readahead_stop_{false};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_BUFFER_POOL_MANAGER_H
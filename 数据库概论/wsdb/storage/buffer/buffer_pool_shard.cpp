@@ -0,0 +1,685 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "buffer_pool_shard.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+#include "../../../common/error.h"
+
+namespace wsdb {
+
+BufferPoolShard::BufferPoolShard(DiskManager *disk_manager, LogManager *log_manager, Page *pages, size_t pool_size,
+    const std::string &replacer, size_t replacer_lru_k)
+    : disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      pool_size_(pool_size),
+      frames_(new Frame[pool_size]),
+      page_frame_lookup_(pool_size)
+{
+  replacer_ = Replacer::Create(replacer, pool_size_, replacer_lru_k);
+  // init frames_ and free_list_
+  for (frame_id_t i = 0; i < static_cast<frame_id_t>(pool_size_); i++) {
+    frames_[i].SetPage(pages + i);
+    free_list_.push_back(i);
+  }
+}
+
+auto BufferPoolShard::FetchFrame(file_id_t fid, page_id_t pid, BufferRing *ring, bool load_page) -> Frame *
+{
+  std::unique_lock<std::mutex> lock(latch_);
+
+  while (true) {
+    frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+    if (frame_id != INVALID_FRAME_ID) {
+      Frame &frame = frames_[frame_id];
+      Page      *page     = frame.GetPage();
+      PinFrame(frame_id);
+      if (!frame.IsIOInProgress()) {
+        return &frame;
+      }
+      // the page is being loaded by another thread, wait for it instead of issuing a second read
+      lock.unlock();
+      frame.WaitIO();
+      if (page->GetTableId() == fid && page->GetPageId() == pid) {
+        return &frame;
+      }
+      // the load failed, give up the pin and try again
+      lock.lock();
+      ReleaseFrame(frame_id);
+      continue;
+    }
+    auto ev = evicting_.find({fid, pid});
+    if (ev != evicting_.end()) {
+      // the page is still being written back, reading it now would get the stale version on disk
+      Frame &frame = frames_[ev->second];
+      lock.unlock();
+      frame.WaitIO();
+      lock.lock();
+      continue;
+    }
+    break;
+  }
+
+  frame_id_t frame_id = ring == nullptr ? GetAvailableFrame() : GetRingFrame(*ring);
+  UpdateFrame(frame_id, fid, pid, lock, load_page);
+  return &frames_[frame_id];
+}
+
+auto BufferPoolShard::UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+  if (frame_id == INVALID_FRAME_ID) {
+    return false;
+  }
+  Frame &frame = frames_[frame_id];
+  if (!frame.InUse()) {
+    return false;
+  }
+  frame.Unpin();
+  if (!frame.InUse() && !frame.InRing()) {
+    replacer_->Unpin(frame_id);
+  }
+  if (is_dirty) {
+    frame.SetDirty(true);
+    auto cl = cleaning_.find({fid, pid});
+    if (cl != cleaning_.end()) {
+      cl->second = true;
+    }
+  }
+  return true;
+}
+
+auto BufferPoolShard::DeletePage(file_id_t fid, page_id_t pid) -> bool
+{
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    WaitCleaned(lock, {fid, pid});
+    frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+    if (frame_id == INVALID_FRAME_ID) {
+      return true;
+    }
+    if (frames_[frame_id].InUse()) {
+      return false;
+    }
+    if (!frames_[frame_id].IsDirty()) {
+      page_frame_lookup_.Erase({fid, pid});
+      EvictFrame(frame_id);
+      return true;
+    }
+    // write the page back without the latch, the page may be fetched again meanwhile so check it again
+    if (!WriteBack(lock, {frame_id})) {
+      return false;
+    }
+  }
+}
+
+auto BufferPoolShard::DeleteAllPages(file_id_t fid) -> bool
+{
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    // a flush or the page cleaner only pins the pages for their write, wait for it instead of failing
+    WaitWritten(lock, fid, true);
+    auto pages = GetFilePages(fid);
+    // nothing is erased unless all pages of the file can be, the file is never left half deleted
+    std::vector<frame_id_t> dirty;
+    for (const auto &[pid, frame_id] : pages) {
+      if (frames_[frame_id].InUse()) {
+        return false;
+      }
+      if (frames_[frame_id].IsDirty()) {
+        dirty.push_back(frame_id);
+      }
+    }
+    if (dirty.empty()) {
+      for (const auto &[pid, frame_id] : pages) {
+        page_frame_lookup_.Erase({fid, pid});
+        EvictFrame(frame_id);
+      }
+      return true;
+    }
+    // write the dirty pages back without the latch, then check again as the pages may be fetched meanwhile
+    if (!WriteBack(lock, dirty)) {
+      return false;
+    }
+  }
+}
+
+auto BufferPoolShard::FlushPage(file_id_t fid, page_id_t pid) -> bool
+{
+  std::unique_lock<std::mutex> lock(latch_);
+  WaitCleaned(lock, {fid, pid});
+
+  frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+  if (frame_id == INVALID_FRAME_ID) {
+    return false;
+  }
+  if (!frames_[frame_id].IsDirty()) {
+    return true;
+  }
+  return WriteBack(lock, {frame_id});
+}
+
+auto BufferPoolShard::BeginFlush(file_id_t fid, page_id_t first_pid, size_t max_pages) -> std::vector<FlushEntry>
+{
+  std::unique_lock<std::mutex> lock(latch_);
+
+  // wait for the write back of evicted and cleaned pages of the file, the caller may close the file right after
+  // flushing, and the writes of the batch must not race with the page cleaner
+  WaitWritten(lock, fid, false);
+
+  std::vector<FlushEntry> batch;
+  for (const auto &[pid, frame_id] : GetFilePages(fid, first_pid)) {
+    if (batch.size() == max_pages) {
+      break;
+    }
+    Frame &frame = frames_[frame_id];
+    if (frame.IsDirty()) {
+      BeginPageFlush(frame_id);
+      batch.push_back({pid, frame_id, &frame});
+    }
+  }
+  return batch;
+}
+
+auto BufferPoolShard::BeginFlush(file_id_t fid, const std::vector<page_id_t> &pids) -> std::vector<FlushEntry>
+{
+  std::unique_lock<std::mutex> lock(latch_);
+
+  // a page of the checkpoint being written back by an eviction is not in the shard, its write must be done before the
+  // checkpoint completes. Start over after every wait, another page may be evicted meanwhile
+  for (size_t i = 0; i < pids.size();) {
+    fid_pid_t key{fid, pids[i]};
+    if (auto ev = evicting_.find(key); ev != evicting_.end()) {
+      Frame &frame = frames_[ev->second];
+      lock.unlock();
+      frame.WaitIO();
+      lock.lock();
+      i = 0;
+      continue;
+    }
+    if (cleaning_.count(key) != 0) {
+      WaitCleaned(lock, key);
+      i = 0;
+      continue;
+    }
+    i++;
+  }
+
+  std::vector<FlushEntry> batch;
+  for (page_id_t pid : pids) {
+    frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+    if (frame_id == INVALID_FRAME_ID) {
+      // written back by an eviction since the dirty page table was taken
+      continue;
+    }
+    Frame &frame = frames_[frame_id];
+    if (frame.IsIOInProgress() || (!frame.IsDirty() && !frame.InUse())) {
+      // being loaded from disk, or written since the dirty page table was taken
+      continue;
+    }
+    BeginPageFlush(frame_id);
+    batch.push_back({pid, frame_id, &frame});
+  }
+  return batch;
+}
+
+void BufferPoolShard::EndFlush(const std::vector<FlushEntry> &batch)
+{
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    for (const auto &entry : batch) {
+      EndPageFlush(entry.frame_id_, entry.written_);
+    }
+  }
+  cleaned_cv_.notify_all();
+}
+
+auto BufferPoolShard::GetFrame(file_id_t fid, page_id_t pid) -> Frame *
+{
+  frame_id_t frame_id = page_frame_lookup_.Find({fid, pid});
+  return frame_id == INVALID_FRAME_ID ? nullptr : &frames_[frame_id];
+}
+
+void BufferPoolShard::ReleaseRing(BufferRing &ring)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  for (frame_id_t frame_id : ring.frames_) {
+    Frame    &frame = frames_[frame_id];
+    fid_pid_t key{frame.GetTableId(), frame.GetPageId()};
+    bool      mapped = page_frame_lookup_.Find(key) == frame_id;
+    if (frame.InUse() || (mapped && frame.IsDirty())) {
+      DetachFromRing(frame_id);
+      if (!frame.InUse()) {
+        replacer_->Unpin(frame_id);
+      }
+      continue;
+    }
+    if (mapped) {
+      page_frame_lookup_.Erase(key);
+    }
+    frame.SetInRing(false);
+    frame.Reset();
+    free_list_.push_back(frame_id);
+  }
+  ring.frames_.clear();
+  ring.next_ = 0;
+}
+
+auto BufferPoolShard::CleanPages(size_t max_pages) -> size_t
+{
+  std::unique_lock<std::mutex> lock(latch_);
+
+  // look ahead a quarter of the shard from the eviction point
+  auto candidates = replacer_->GetVictimCandidates(std::max(pool_size_ / 4, max_pages));
+  std::vector<std::pair<fid_pid_t, frame_id_t>> batch;
+  for (frame_id_t frame_id : candidates) {
+    if (batch.size() == max_pages) {
+      break;
+    }
+    Frame &frame = frames_[frame_id];
+    if (!frame.IsDirty() || frame.InUse()) {
+      continue;
+    }
+    fid_pid_t key{frame.GetTableId(), frame.GetPageId()};
+    if (!cleaning_.emplace(key, false).second) {
+      continue;
+    }
+    batch.emplace_back(key, frame_id);
+  }
+  if (batch.empty()) {
+    return 0;
+  }
+  // write copies in page order, the page can be modified by others during the write
+  std::sort(batch.begin(), batch.end(), [](const auto &a, const auto &b) { return a.first.Pack() < b.first.Pack(); });
+  std::vector<char> copies(batch.size() * PAGE_SIZE);
+  for (size_t i = 0; i < batch.size(); i++) {
+    std::memcpy(&copies[i * PAGE_SIZE], frames_[batch[i].second].GetPage()->GetData(), PAGE_SIZE);
+  }
+  lock.unlock();
+  FlushLog();
+
+  // runs of consecutive pages of a file are written at once, all runs are in flight at the same time
+  std::vector<bool>                                     written(batch.size(), false);
+  std::vector<std::tuple<io_ticket_t, size_t, size_t>> writes;
+  std::vector<const char *>                             run;
+  for (size_t first = 0, end = 0; first < batch.size(); first = end) {
+    run.clear();
+    for (end = first; end < batch.size(); end++) {
+      if (end > first && batch[end].first.Pack() != batch[end - 1].first.Pack() + 1) {
+        break;
+      }
+      run.push_back(&copies[end * PAGE_SIZE]);
+    }
+    writes.emplace_back(disk_manager_->SubmitWritePages(batch[first].first.fid, batch[first].first.pid, run), first, end);
+  }
+  for (auto [ticket, first, end] : writes) {
+    try {
+      disk_manager_->WaitIO(ticket);
+      std::fill(written.begin() + static_cast<ptrdiff_t>(first), written.begin() + static_cast<ptrdiff_t>(end), true);
+    } catch (WSDBException_ &e) {
+      // leave the pages dirty, eviction will write them
+    }
+  }
+
+  lock.lock();
+  size_t num_written = 0;
+  for (size_t i = 0; i < batch.size(); i++) {
+    auto &[key, frame_id] = batch[i];
+    if (written[i] && !cleaning_[key] && page_frame_lookup_.Find(key) == frame_id) {
+      frames_[frame_id].SetDirty(false);
+    }
+    cleaning_.erase(key);
+    num_written += written[i] ? 1 : 0;
+  }
+  stats_.cleaner_writes_ += num_written;
+  lock.unlock();
+  cleaned_cv_.notify_all();
+  return num_written;
+}
+
+auto BufferPoolShard::GetStats() -> BufferPoolStats
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  return stats_;
+}
+
+auto BufferPoolShard::GetDirtyPages() -> std::vector<fid_pid_t>
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  std::vector<fid_pid_t>      pages;
+  page_frame_lookup_.ForEach([this, &pages](const fid_pid_t &key, frame_id_t frame_id) {
+    const Frame &frame = frames_[frame_id];
+    if (frame.IsDirty() || (frame.InUse() && !frame.IsIOInProgress())) {
+      pages.push_back(key);
+    }
+  });
+  for (const auto &ev : evicting_) {
+    pages.push_back(ev.first);
+  }
+  return pages;
+}
+
+auto BufferPoolShard::GetAvailableFrame() -> frame_id_t
+{
+  if (!free_list_.empty()) {
+    frame_id_t frame_id = free_list_.front();
+    free_list_.pop_front();
+    return frame_id;
+  }
+  frame_id_t frame_id;
+  if (replacer_->Victim(&frame_id)) {
+    return frame_id;
+  }
+  WSDB_THROW(WSDB_NO_FREE_FRAME, "error: no free frame");
+}
+
+auto BufferPoolShard::GetRingFrame(BufferRing &ring) -> frame_id_t
+{
+  if (ring.frames_.size() < ring.capacity_) {
+    frame_id_t frame_id = GetAvailableFrame();
+    frames_[frame_id].SetInRing(true);
+    ring.frames_.push_back(frame_id);
+    return frame_id;
+  }
+  frame_id_t &slot = ring.frames_[ring.next_];
+  ring.next_       = (ring.next_ + 1) % ring.frames_.size();
+  if (!frames_[slot].InUse()) {
+    return slot;
+  }
+  // someone else is still using the page, e.g. a point lookup, leave it to the main pool
+  frame_id_t frame_id = GetAvailableFrame();
+  DetachFromRing(slot);
+  frames_[frame_id].SetInRing(true);
+  slot = frame_id;
+  return frame_id;
+}
+
+void BufferPoolShard::PinFrame(frame_id_t frame_id)
+{
+  frames_[frame_id].Pin();
+  if (!frames_[frame_id].InRing()) {
+    replacer_->Pin(frame_id);
+  }
+}
+
+void BufferPoolShard::DetachFromRing(frame_id_t frame_id)
+{
+  Frame &frame = frames_[frame_id];
+  frame.SetInRing(false);
+  replacer_->SetPage(frame_id, fid_pid_t{frame.GetTableId(), frame.GetPageId()}.Pack());
+  replacer_->Pin(frame_id);
+}
+
+auto BufferPoolShard::ClaimForReadAhead(file_id_t fid, page_id_t pid, BufferRing *ring) -> std::optional<FrameClaim>
+{
+  std::unique_lock<std::mutex> lock(latch_);
+
+  if (page_frame_lookup_.Contains({fid, pid}) || evicting_.count({fid, pid}) != 0) {
+    return std::nullopt;
+  }
+  frame_id_t frame_id;
+  try {
+    frame_id = ring == nullptr ? GetAvailableFrame() : GetRingFrame(*ring);
+  } catch (WSDBException_ &e) {
+    // every frame is pinned, read-ahead is only a hint
+    return std::nullopt;
+  }
+  return ClaimFrame(frame_id, fid, pid, lock);
+}
+
+auto BufferPoolShard::GetClaimedData(const FrameClaim &claim) -> char *
+{
+  return frames_[claim.frame_id_].GetPage()->GetData();
+}
+
+void BufferPoolShard::WriteVictim(FrameClaim &claim)
+{
+  if (claim.victim_dirty_ && !claim.victim_written_) {
+    FlushLog();
+    disk_manager_->WritePage(claim.victim_.fid, claim.victim_.pid, GetClaimedData(claim));
+    claim.victim_written_ = true;
+  }
+}
+
+void BufferPoolShard::FinishReadAhead(FrameClaim &claim, bool loaded)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (!loaded) {
+    AbortClaim(claim);
+    return;
+  }
+  Frame &frame = frames_[claim.frame_id_];
+  frame.GetPage()->SetTablePageId(claim.page_.fid, claim.page_.pid);
+  if (claim.victim_dirty_) {
+    evicting_.erase(claim.victim_);
+  }
+  frame.EndIO();
+  ReleaseFrame(claim.frame_id_);
+}
+
+auto BufferPoolShard::ClaimFrame(
+    frame_id_t frame_id, file_id_t fid, page_id_t pid, std::unique_lock<std::mutex> &lock) -> FrameClaim
+{
+  Frame     &frame = frames_[frame_id];
+  FrameClaim claim{frame_id, {fid, pid}, {frame.GetTableId(), frame.GetPageId()}, frame.IsDirty(), false};
+
+  if (page_frame_lookup_.Find(claim.victim_) == frame_id) {
+    page_frame_lookup_.Erase(claim.victim_);
+    stats_.evictions_++;
+  }
+  if (claim.victim_dirty_) {
+    evicting_[claim.victim_] = frame_id;
+    stats_.sync_writes_++;
+  }
+  // publish the new page before doing any I/O, concurrent fetches of it will wait on this frame
+  page_frame_lookup_.Insert(claim.page_, frame_id);
+  frame.SetTablePageId(fid, pid);
+  frame.SetDirty(false);
+  if (!frame.InRing()) {
+    replacer_->SetPage(frame_id, claim.page_.Pack());
+  }
+  PinFrame(frame_id);
+  frame.BeginIO();
+  if (claim.victim_dirty_) {
+    WaitCleaned(lock, claim.victim_);
+  }
+  return claim;
+}
+
+void BufferPoolShard::AbortClaim(FrameClaim &claim)
+{
+  page_frame_lookup_.Erase(claim.page_);
+  RollbackFrame(claim.frame_id_, claim.victim_, !claim.victim_written_);
+}
+
+void BufferPoolShard::UpdateFrame(
+    frame_id_t frame_id, file_id_t fid, page_id_t pid, std::unique_lock<std::mutex> &lock, bool load_page)
+{
+  FrameClaim claim = ClaimFrame(frame_id, fid, pid, lock);
+  lock.unlock();
+
+  Page *page = frames_[frame_id].GetPage();
+  try {
+    WriteVictim(claim);
+    page->Clear();
+    if (load_page) {
+      disk_manager_->ReadPage(fid, pid, page->GetData());
+    }
+    page->SetTablePageId(fid, pid);
+  } catch (WSDBException_ &e) {
+    lock.lock();
+    AbortClaim(claim);
+    lock.unlock();
+    throw;
+  }
+
+  if (claim.victim_dirty_) {
+    lock.lock();
+    evicting_.erase(claim.victim_);
+    lock.unlock();
+  }
+  frames_[frame_id].EndIO();
+}
+
+void BufferPoolShard::RollbackFrame(frame_id_t frame_id, const fid_pid_t &victim, bool victim_restored)
+{
+  Frame &frame = frames_[frame_id];
+  evicting_.erase(victim);
+  if (victim_restored && !page_frame_lookup_.Contains(victim)) {
+    // the victim page is untouched in the frame, keep it in the pool unless it has been fetched again meanwhile
+    page_frame_lookup_.Insert(victim, frame_id);
+    frame.SetTablePageId(victim.fid, victim.pid);
+    frame.SetDirty(true);
+  } else {
+    frame.GetPage()->Clear();
+    frame.SetTablePageId(INVALID_TABLE_ID, INVALID_PAGE_ID);
+  }
+  frame.EndIO();
+  ReleaseFrame(frame_id);
+}
+
+void BufferPoolShard::ReleaseFrame(frame_id_t frame_id)
+{
+  Frame &frame = frames_[frame_id];
+  frame.Unpin();
+  if (frame.InUse() || frame.InRing()) {
+    return;
+  }
+  if (page_frame_lookup_.Find({frame.GetTableId(), frame.GetPageId()}) == frame_id) {
+    replacer_->Unpin(frame_id);
+  } else {
+    frame.Reset();
+    free_list_.push_back(frame_id);
+    replacer_->Remove(frame_id);
+  }
+}
+
+void BufferPoolShard::WaitCleaned(std::unique_lock<std::mutex> &lock, const fid_pid_t &key)
+{
+  cleaned_cv_.wait(lock, [this, &key] { return cleaning_.count(key) == 0; });
+}
+
+void BufferPoolShard::WaitWritten(std::unique_lock<std::mutex> &lock, file_id_t fid, bool wait_flushes)
+{
+  auto of_file = [fid](const auto &entry) { return entry.first.fid == fid; };
+  while (true) {
+    auto ev = std::find_if(evicting_.begin(), evicting_.end(), of_file);
+    if (ev != evicting_.end()) {
+      Frame &frame = frames_[ev->second];
+      lock.unlock();
+      frame.WaitIO();
+      lock.lock();
+      continue;
+    }
+    if (std::any_of(cleaning_.begin(), cleaning_.end(), of_file) ||
+        (wait_flushes && std::any_of(flushing_.begin(), flushing_.end(), of_file))) {
+      cleaned_cv_.wait(lock);
+      continue;
+    }
+    return;
+  }
+}
+
+void BufferPoolShard::BeginPageFlush(frame_id_t frame_id)
+{
+  Frame &frame = frames_[frame_id];
+  PinFrame(frame_id);
+  frame.SetDirty(false);
+  flushing_[{frame.GetTableId(), frame.GetPageId()}]++;
+}
+
+void BufferPoolShard::EndPageFlush(frame_id_t frame_id, bool written)
+{
+  Frame &frame = frames_[frame_id];
+  if (!written) {
+    frame.SetDirty(true);
+  }
+  auto it = flushing_.find({frame.GetTableId(), frame.GetPageId()});
+  if (--it->second == 0) {
+    flushing_.erase(it);
+  }
+  ReleaseFrame(frame_id);
+}
+
+auto BufferPoolShard::WriteBack(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &frame_ids) -> bool
+{
+  // the frames stay pinned during the writes, a concurrent unpin may set them dirty again
+  for (frame_id_t frame_id : frame_ids) {
+    BeginPageFlush(frame_id);
+  }
+  lock.unlock();
+  std::vector<bool> written(frame_ids.size(), false);
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    Frame &frame = frames_[frame_ids[i]];
+    try {
+      // a writer holding the page must finish first, otherwise a half updated page may reach the disk
+      std::shared_lock<std::shared_mutex> page_lock(frame.GetLatch());
+      FlushLog();
+      disk_manager_->WritePage(frame.GetTableId(), frame.GetPageId(), frame.GetPage()->GetData());
+      written[i] = true;
+    } catch (WSDBException_ &e) {
+      WSDB_LOG_ERROR(e.what());
+    }
+  }
+  lock.lock();
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    EndPageFlush(frame_ids[i], written[i]);
+  }
+  cleaned_cv_.notify_all();
+  return std::all_of(written.begin(), written.end(), [](bool w) { return w; });
+}
+
+auto BufferPoolShard::GetFilePages(file_id_t fid, page_id_t first_pid) -> std::vector<std::pair<page_id_t, frame_id_t>>
+{
+  std::vector<std::pair<page_id_t, frame_id_t>> pages;
+  page_frame_lookup_.ForEachOfFile(fid, [first_pid, &pages](page_id_t pid, frame_id_t frame_id) {
+    if (pid >= first_pid) {
+      pages.emplace_back(pid, frame_id);
+    }
+  });
+  std::sort(pages.begin(), pages.end());
+  return pages;
+}
+
+void BufferPoolShard::FlushLog()
+{
+  if (log_manager_ != nullptr) {
+    log_manager_->FlushLog();
+  }
+}
+
+void BufferPoolShard::EvictFrame(frame_id_t frame_id)
+{
+  Frame &frame = frames_[frame_id];
+  WSDB_ASSERT(!frame.IsDirty() && !frame.InUse(), "evict a dirty or pinned frame");
+  frame.Reset();
+  if (frame.InRing()) {
+    // the ring reuses the empty frame
+    return;
+  }
+  free_list_.push_back(frame_id);
+  replacer_->Remove(frame_id);
+}
+
+}  // namespace wsdb
@@ -0,0 +1,390 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_BUFFER_POOL_SHARD_H
+#define WSDB_BUFFER_POOL_SHARD_H
+
+#include <condition_variable>  // NOLINT
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "storage/disk/disk_manager.h"
+#include "log/log_manager.h"
+#include "replacer/replacer.h"
+#include "buffer_access_strategy.h"
+#include "frame.h"
+#include "page_table.h"
+#include "common/page.h"
+
+namespace wsdb {
+
+struct BufferPoolStats
+{
+  size_t evictions_{0};       // pages evicted to make room for another page
+  size_t sync_writes_{0};     // evicted pages that were dirty and written by the query causing the eviction
+  size_t cleaner_writes_{0};  // pages written ahead of eviction by the page cleaner
+};
+
+/**
+ * A dirty page pinned by BufferPoolShard::BeginFlush to be written by the caller
+ */
+struct FlushEntry
+{
+  page_id_t  pid_;
+  frame_id_t frame_id_;
+  Frame     *frame_;
+  bool       written_{false};
+};
+
+/**
+ * A frame taken over for a page being loaded, the frame is pinned and doing I/O until the load finishes
+ */
+struct FrameClaim
+{
+  frame_id_t frame_id_;
+  fid_pid_t  page_;    // the page being loaded
+  fid_pid_t  victim_;  // the page held by the frame before
+  bool       victim_dirty_;
+  bool       victim_written_;
+};
+
+/**
+ * One independent partition of the buffer pool. A shard owns its frames, free list, replacer and page table, all
+ * protected by its own latch, so threads working on pages of different shards never contend with each other.
+ * Frame ids are local to the shard.
+ */
+class BufferPoolShard
+{
+public:
+  /**
+   * @param disk_manager
+   * @param log_manager
+   * @param pages memory of the pages of the shard, pool_size pages in the PageRegion of the buffer pool
+   * @param pool_size number of frames owned by the shard
+   * @param replacer replacement policy, see Replacer::Create
+   * @param replacer_lru_k k used by LRUKReplacer
+   */
+  BufferPoolShard(DiskManager *disk_manager, LogManager *log_manager, Page *pages, size_t pool_size,
+      const std::string &replacer, size_t replacer_lru_k);
+
+  ~BufferPoolShard() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(BufferPoolShard)
+
+  /**
+   * Fetch the requested page from disk.
+   * 1. grant the latch
+   * 2. check if the page is in the frame, if so pin the frame both in the buffer and the replacer, and if the page is
+   * still being loaded by another thread, release the latch and wait for the I/O of the frame
+   * 3. if the page is being written back from an evicted frame, wait for the write and retry
+   * 4. if the page is not in the frame, GetAvailableFrame (or GetRingFrame if a ring is given) and UpdateFrame
+   * @param fid file that the page belongs to
+   * @param pid page id
+   * @param ring ring of the buffer access strategy of the caller, nullptr for normal accesses
+   * @param load_page false for a page not on disk yet, the frame is zero-filled instead of read
+   * @return the pinned frame holding the page
+   */
+  auto FetchFrame(file_id_t fid, page_id_t pid, BufferRing *ring = nullptr, bool load_page = true) -> Frame *;
+
+  /**
+   * Unpin the page indicating that it can be victimized
+   * 1. grant the latch
+   * 2. if the frame is not in the buffer or the frame is not in use, return false
+   * 3. unpin the frame, after that if the frame is not in use, unpin the frame in the replacer
+   * 4. set the frame dirty if the page is dirty
+   * @param fid
+   * @param pid
+   * @param is_dirty
+   * @return true if the page is unpinned successfully
+   */
+  auto UnpinPage(file_id_t fid, page_id_t pid, bool is_dirty) -> bool;
+
+  /**
+   * Delete the page from the shard
+   * 1. grant the latch
+   * 2. if the page is not in the buffer, return true
+   * 3. if the page is in use, return false
+   * 4. if the page is dirty, write it back like FlushPage and start over, a failed write returns false
+   * 5. update the page_frame_lookup_, reset the frame, add the frame to the free list and remove it from the replacer
+   * @param fid
+   * @param pid
+   * @return true if the page is deleted successfully
+   */
+  auto DeletePage(file_id_t fid, page_id_t pid) -> bool;
+
+  /**
+   * Delete all pages of the file held by this shard, or none of them if a page is in use. Pages pinned by a flush or
+   * being written by the page cleaner are waited for, dirty pages are written back without holding the latch and the
+   * pages are only dropped once they are all clean. The pages of the file are found by GetFilePages
+   * @param fid
+   * @return true if all pages are deleted, false if a page is in use or can not be written
+   */
+  auto DeleteAllPages(file_id_t fid) -> bool;
+
+  /**
+   * Flush the page to disk
+   * 1. grant the latch
+   * 2. if the page is not in the buffer, return false
+   * 3. if the page is dirty, pin the frame, clear the dirty flag and write the page without holding the latch, under
+   * the shared latch of the page so that no page guard is writing it
+   * @param fid
+   * @param pid
+   * @return true if the page is flushed successfully
+   */
+  auto FlushPage(file_id_t fid, page_id_t pid) -> bool;
+
+  /**
+   * Start flushing the pages of the file held by this shard, the pages are written by the caller in a batch together
+   * with those of the other shards
+   * 1. grant the latch, wait until no page of the file is being written back by an eviction or the page cleaner
+   * 2. pin at most max_pages dirty pages of the file from first_pid on, in page order, and clear their dirty flag
+   * the caller writes each page under its shared latch like FlushPage, then calls EndFlush
+   * @param fid
+   * @param first_pid
+   * @param max_pages
+   * @return the pinned pages
+   */
+  auto BeginFlush(file_id_t fid, page_id_t first_pid, size_t max_pages) -> std::vector<FlushEntry>;
+
+  /**
+   * Start writing the pages of a checkpoint held by this shard, like BeginFlush but only for the given pages
+   * 1. grant the latch, wait until none of the pages is being written back by an eviction or the page cleaner
+   * 2. pin the pages that are still in the shard and dirty or in use, and clear their dirty flag. A page in use is
+   * written even if it is clean, its writer may not have unpinned it as dirty yet
+   * the caller writes them like the pages of BeginFlush, then calls EndFlush
+   * @param fid
+   * @param pids pages of the file in the dirty page table of the checkpoint
+   * @return the pinned pages
+   */
+  auto BeginFlush(file_id_t fid, const std::vector<page_id_t> &pids) -> std::vector<FlushEntry>;
+
+  /**
+   * Unpin the pages of BeginFlush, the pages not written become dirty again
+   */
+  void EndFlush(const std::vector<FlushEntry> &batch);
+
+  /**
+   * Get the frame, used for test
+   */
+  auto GetFrame(file_id_t fid, page_id_t pid) -> Frame *;
+
+  /**
+   * Return the frames of the ring to the shard. Clean unpinned pages are dropped to the free list since a scan
+   * rarely reads them again, the others are handed over to the replacer
+   * @param ring
+   */
+  void ReleaseRing(BufferRing &ring);
+
+  /**
+   * Write back the dirty pages that are likely to be evicted soon, so that eviction finds clean victims
+   * 1. grant the latch, peek the next victims of the replacer
+   * 2. copy at most max_pages dirty and unpinned pages among them and record them in cleaning_
+   * 3. release the latch and write the copies
+   * 4. grant the latch again, clear the dirty flag of the pages that are not modified during the write
+   * @param max_pages I/O budget of this round
+   * @return number of pages written
+   */
+  auto CleanPages(size_t max_pages) -> size_t;
+
+  auto GetStats() -> BufferPoolStats;
+
+  /**
+   * Get the pages of the shard that may hold changes not on disk yet: dirty pages, pages in use, whose writers set the
+   * dirty flag only when they unpin them, and dirty victims still being written back by an eviction
+   * @return
+   */
+  auto GetDirtyPages() -> std::vector<fid_pid_t>;
+
+  /// read-ahead, a page is loaded asynchronously by ClaimForReadAhead, WriteVictim, reading into GetClaimedData and
+  /// FinishReadAhead, only the first and the last one take the latch
+
+  /**
+   * Claim a frame for a page to be read ahead, like a fetch of the page without the I/O.
+   * Fetches of the page wait on the frame until FinishReadAhead
+   * @param fid
+   * @param pid
+   * @param ring ring of the buffer access strategy of the scan, nullptr for normal accesses
+   * @return the claim, nullopt if the page is already in the shard or no frame can be evicted
+   */
+  auto ClaimForReadAhead(file_id_t fid, page_id_t pid, BufferRing *ring) -> std::optional<FrameClaim>;
+
+  /**
+   * @return the buffer to load the claimed page into, valid after WriteVictim
+   */
+  auto GetClaimedData(const FrameClaim &claim) -> char *;
+
+  /**
+   * Write back the page evicted by the claim if it is dirty, without holding the latch
+   */
+  void WriteVictim(FrameClaim &claim);
+
+  /**
+   * Publish the claimed page if it is loaded, otherwise give the frame up like a failed fetch.
+   * The pin held by the claim is dropped, so the page can be evicted before anyone fetches it
+   * @param claim
+   * @param loaded whether the page is read into GetClaimedData
+   */
+  void FinishReadAhead(FrameClaim &claim, bool loaded);
+
+private:
+  /// sub procedures used by public APIs, should not be locked by latch
+
+  /**
+   * Get the available frame
+   * 1. if the free list is not empty, get the frame id from the free list
+   * 2. else use the replacer to get the frame id
+   * 3. if no frame can be evicted, throw WSDB_NO_FREE_FRAME
+   * @return the frame id
+   */
+  auto GetAvailableFrame() -> frame_id_t;
+
+  /**
+   * Get a frame for the ring
+   * 1. if the ring is not full, take a frame from GetAvailableFrame and add it to the ring
+   * 2. else reuse the next frame of the ring if it is not in use
+   * 3. else hand the frame over to the replacer and put a frame from GetAvailableFrame into its slot
+   * @param ring
+   * @return the frame id
+   */
+  auto GetRingFrame(BufferRing &ring) -> frame_id_t;
+
+  /**
+   * Pin the frame in the buffer, and in the replacer unless the frame belongs to a ring, must hold the latch
+   */
+  void PinFrame(frame_id_t frame_id);
+
+  /**
+   * Move a frame out of its ring and let the replacer track it, must hold the latch
+   */
+  void DetachFromRing(frame_id_t frame_id);
+
+  /**
+   * Take the frame over for a new page, must hold the latch
+   * 1. map the new page to the frame in page_frame_lookup_, if the old page is dirty, record it in evicting_
+   * 2. pin the frame in the buffer and the replacer and mark the frame as doing I/O
+   * 3. if the old page is dirty and being written by the page cleaner, wait for it
+   * @return the claim
+   */
+  auto ClaimFrame(frame_id_t frame_id, file_id_t fid, page_id_t pid, std::unique_lock<std::mutex> &lock)
+      -> FrameClaim;
+
+  /**
+   * Undo a claim whose I/O failed, must hold the latch
+   */
+  void AbortClaim(FrameClaim &claim);
+
+  /**
+   * Update the frame, called with the latch held and returns with the latch released
+   * 1. ClaimFrame
+   * 2. release the latch, write the old page back if it is dirty and read the new page into the frame (if load_page)
+   * 3. grant the latch again to clean up evicting_, then finish the I/O to wake up waiting threads
+   * if any I/O fails, the frame is given up by AbortClaim and the exception is rethrown
+   * @param frame_id the frame to update
+   * @param fid the file needs to be updated to the frame
+   * @param pid the page needs to be updated to the frame
+   * @param lock the held latch
+   * @param load_page
+   */
+  void UpdateFrame(
+      frame_id_t frame_id, file_id_t fid, page_id_t pid, std::unique_lock<std::mutex> &lock, bool load_page = true);
+
+  /**
+   * Undo a failed UpdateFrame, must hold the latch.
+   * If the victim was not written back, the frame keeps the victim page, otherwise the frame is emptied
+   */
+  void RollbackFrame(frame_id_t frame_id, const fid_pid_t &victim, bool victim_restored);
+
+  /**
+   * Drop one pin on the frame, the frame goes back to the replacer if it still holds a page, or to the free list and
+   * out of the replacer if its load failed, must hold the latch. Frames of a ring stay in the ring
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * Wait until the page cleaner finishes writing the page, a second write of the page must not race with it
+   */
+  void WaitCleaned(std::unique_lock<std::mutex> &lock, const fid_pid_t &key);
+
+  /**
+   * Wait until no page of the file is being written back by an eviction or the page cleaner, and also by a flush if
+   * wait_flushes. A flush must not wait for other flushes, it may hold pins of the file in other shards
+   */
+  void WaitWritten(std::unique_lock<std::mutex> &lock, file_id_t fid, bool wait_flushes);
+
+  /**
+   * Pin a dirty frame to be written by a flush and clear its dirty flag, must hold the latch
+   */
+  void BeginPageFlush(frame_id_t frame_id);
+
+  /**
+   * Drop the pin of BeginPageFlush, the page becomes dirty again if it is not written, must hold the latch
+   */
+  void EndPageFlush(frame_id_t frame_id, bool written);
+
+  /**
+   * Write the dirty frames back, called with the latch held, which is released during the writes like FlushPage
+   * @return true if all frames are written
+   */
+  auto WriteBack(std::unique_lock<std::mutex> &lock, const std::vector<frame_id_t> &frame_ids) -> bool;
+
+  /**
+   * Get the pages of the file from first_pid on, must hold the latch. Only the frames of the file are visited, through
+   * the per-file lists of the page table
+   * @return the pages in page order with their frames
+   */
+  auto GetFilePages(file_id_t fid, page_id_t first_pid = 0) -> std::vector<std::pair<page_id_t, frame_id_t>>;
+
+  /**
+   * Flush the log manager before writing pages, the writers of the pages have logged their changes before releasing
+   * the page latch, does nothing without a log manager
+   */
+  void FlushLog();
+
+  /**
+   * Return a clean frame that is not in use to the free list, the replacer stops tracking it so that the frame is
+   * never handed out twice. Frames of a ring are only emptied
+   */
+  void EvictFrame(frame_id_t frame_id);
+
+private:
+  std::mutex                                latch_;
+  DiskManager                              *disk_manager_;
+  LogManager                               *log_manager_;
+  std::unique_ptr<Replacer>                 replacer_;
+  size_t                                    pool_size_;
+  std::unique_ptr<Frame[]>                  frames_;  // metadata only, the pages are owned by the buffer pool
+  std::list<frame_id_t>                     free_list_;
+  PageTable                                 page_frame_lookup_;
+  // dirty pages that have been evicted but not yet written back, a fetch of such a page must wait for the write
+  std::unordered_map<fid_pid_t, frame_id_t> evicting_;
+  // pages being written by the page cleaner, mapped to whether they are dirtied again during the write.
+  // they stay dirty until the write completes, so an eviction or a flush of them waits on cleaned_cv_ first
+  std::unordered_map<fid_pid_t, bool> cleaning_;
+  // pages pinned by FlushPage, BeginFlush or WriteBack for their write, mapped to the number of such flushes
+  std::unordered_map<fid_pid_t, size_t> flushing_;
+  std::condition_variable               cleaned_cv_;  // notified when a write of the cleaner or of a flush finishes
+  BufferPoolStats                     stats_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_BUFFER_POOL_SHARD_H
@@ -1,67 +1,135 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/18.
-//
-
-#ifndef WSDB_FRAME_H
-#define WSDB_FRAME_H
-
-#include "common/types.h"
-#include "common/config.h"
-#include "common/page.h"
-class Frame
-{
-public:
-  Frame()  = default;
-  ~Frame() = default;
-
-  DISABLE_COPY_MOVE_AND_ASSIGN(Frame)
-
-  [[nodiscard]] inline auto GetPage() -> Page * { return &page_; }
-
-  [[nodiscard]] inline auto InUse() const -> bool { return pin_count_ > 0; }
-
-  [[nodiscard]] inline auto IsDirty() const -> bool { return is_dirty_; }
-
-  inline void SetDirty(bool dirty) { is_dirty_ = dirty; }
-
-  [[nodiscard]] inline auto GetPinCount() const -> int { return pin_count_; }
-
-  inline void Pin() { pin_count_++; }
-
-  inline void Unpin()
-  {
-    WSDB_ASSERT(pin_count_ > 0, "Unpin a frame with pin_count = 0");
-    pin_count_--;
-  }
-
-  inline void Reset()
-  {
-    page_.Clear();
-    is_dirty_  = false;
-    pin_count_ = 0;
-  }
-
-private:
-  Page page_{};
-  bool is_dirty_{false};
-  int  pin_count_{0};
-};
-
-#endif  // WSDB_FRAME_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/18.
+//
+
+#ifndef WSDB_FRAME_H
+#define WSDB_FRAME_H
+
+#include <atomic>
+#include <shared_mutex>  // NOLINT
+#include "common/types.h"
+#include "common/config.h"
+#include "common/page.h"
+/**
+ * Metadata of a frame, the page itself lives in the PageRegion of the buffer pool. Frames are small and stored in one
+ * array, so the buffer pool finds and checks them without touching the page memory, and the key of the held page is
+ * kept here for the same reason
+ */
+class Frame
+{
+public:
+  Frame()  = default;
+  ~Frame() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(Frame)
+
+  [[nodiscard]] inline auto GetPage() -> Page * { return page_; }
+
+  /**
+   * Attach the page memory of the frame, called once when the buffer pool is created
+   */
+  inline void SetPage(Page *page) { page_ = page; }
+
+  [[nodiscard]] inline auto GetTableId() const -> table_id_t { return table_id_; }
+
+  [[nodiscard]] inline auto GetPageId() const -> page_id_t { return page_id_; }
+
+  /**
+   * Set the page held by the frame, it is set as soon as the frame is claimed for the page, before the page is loaded
+   */
+  inline void SetTablePageId(table_id_t table_id, page_id_t page_id)
+  {
+    table_id_ = table_id;
+    page_id_  = page_id;
+  }
+
+  [[nodiscard]] inline auto InUse() const -> bool { return pin_count_ > 0; }
+
+  [[nodiscard]] inline auto IsDirty() const -> bool { return is_dirty_; }
+
+  inline void SetDirty(bool dirty) { is_dirty_ = dirty; }
+
+  [[nodiscard]] inline auto GetPinCount() const -> int { return pin_count_; }
+
+  inline void Pin() { pin_count_++; }
+
+  inline void Unpin()
+  {
+    WSDB_ASSERT(pin_count_ > 0, "Unpin a frame with pin_count = 0");
+    pin_count_--;
+  }
+
+  [[nodiscard]] inline auto IsIOInProgress() const -> bool { return io_in_progress_.load(); }
+
+  /**
+   * Mark that the page of the frame is being read from or written to disk, the frame should be pinned by the caller
+   */
+  inline void BeginIO() { io_in_progress_.store(true); }
+
+  /**
+   * Clear the I/O state and wake up all threads waiting for the frame
+   */
+  inline void EndIO()
+  {
+    io_in_progress_.store(false);
+    io_in_progress_.notify_all();
+  }
+
+  /**
+   * Block until the I/O on the frame is finished, should not hold the buffer pool latch
+   */
+  inline void WaitIO() const { io_in_progress_.wait(true); }
+
+  /**
+   * Latch protecting the content of the page, taken by the page guards while the frame is pinned.
+   * It is never taken with the buffer pool latch held, since a guard holder may fetch another page
+   */
+  [[nodiscard]] inline auto GetLatch() -> std::shared_mutex & { return latch_; }
+
+  [[nodiscard]] inline auto InRing() const -> bool { return in_ring_; }
+
+  /**
+   * Mark that the frame is owned by the ring of a buffer access strategy, it is not tracked by the replacer and is
+   * recycled by the ring only
+   */
+  inline void SetInRing(bool in_ring) { in_ring_ = in_ring; }
+
+  inline void Reset()
+  {
+    page_->Clear();
+    table_id_  = INVALID_TABLE_ID;
+    page_id_   = INVALID_PAGE_ID;
+    is_dirty_  = false;
+    pin_count_ = 0;
+  }
+
+private:
+  Page      *page_{nullptr};
+  table_id_t table_id_{INVALID_TABLE_ID};
+  page_id_t  page_id_{INVALID_PAGE_ID};
+  int        pin_count_{0};
+  bool       is_dirty_{false};
+  bool       in_ring_{false};
+  // set while the page is loaded from or written to disk outside the buffer pool latch
+  std::atomic<bool> io_in_progress_{false};
+  std::shared_mutex latch_;
+};
+
+#endif  // WSDB_FRAME_H
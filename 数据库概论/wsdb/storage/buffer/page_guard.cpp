@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "page_guard.h"
+#include <utility>
+
+#include "buffer_pool_manager.h"
+
+namespace wsdb {
+
+PageGuard::PageGuard(BufferPoolManager *bpm, file_id_t fid, page_id_t pid, Frame *frame, bool exclusive)
+    : bpm_(bpm), fid_(fid), pid_(pid), frame_(frame), exclusive_(exclusive)
+{
+  if (exclusive_) {
+    frame_->GetLatch().lock();
+  } else {
+    frame_->GetLatch().lock_shared();
+  }
+}
+
+PageGuard::PageGuard(PageGuard &&other) noexcept
+    : bpm_(other.bpm_),
+      fid_(other.fid_),
+      pid_(other.pid_),
+      frame_(std::exchange(other.frame_, nullptr)),
+      exclusive_(other.exclusive_)
+{}
+
+auto PageGuard::operator=(PageGuard &&other) noexcept -> PageGuard &
+{
+  if (this != &other) {
+    Drop();
+    bpm_       = other.bpm_;
+    fid_       = other.fid_;
+    pid_       = other.pid_;
+    frame_     = std::exchange(other.frame_, nullptr);
+    exclusive_ = other.exclusive_;
+  }
+  return *this;
+}
+
+void PageGuard::Drop()
+{
+  if (frame_ == nullptr) {
+    return;
+  }
+  // a writer unpins the page dirty before releasing the latch, otherwise a flush taking the latch in between sees a
+  // clean page and skips the change. The page latch may be held while taking the buffer pool latch, not the reverse
+  Frame *frame = std::exchange(frame_, nullptr);
+  if (exclusive_) {
+    bpm_->UnpinPage(fid_, pid_, true);
+    frame->GetLatch().unlock();
+  } else {
+    frame->GetLatch().unlock_shared();
+    bpm_->UnpinPage(fid_, pid_, false);
+  }
+}
+
+}  // namespace wsdb
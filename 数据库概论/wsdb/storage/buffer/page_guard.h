@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_PAGE_GUARD_H
+#define WSDB_PAGE_GUARD_H
+
+#include "../../../common/micro.h"
+#include "common/page.h"
+#include "common/types.h"
+#include "frame.h"
+
+namespace wsdb {
+
+class BufferPoolManager;
+
+/**
+ * A pinned and latched page, the latch is released and the page unpinned when the guard is dropped or destroyed.
+ * The page must only be accessed while the guard holds it. Get one from BufferPoolManager::FetchPageRead or
+ * BufferPoolManager::FetchPageWrite, a guard can be moved but not copied
+ */
+class PageGuard
+{
+public:
+  PageGuard() = default;
+
+  PageGuard(const PageGuard &)                     = delete;
+  auto operator=(const PageGuard &) -> PageGuard & = delete;
+
+  PageGuard(PageGuard &&other) noexcept;
+
+  auto operator=(PageGuard &&other) noexcept -> PageGuard &;
+
+  ~PageGuard() { Drop(); }
+
+  /**
+   * Release the latch and unpin the page. An exclusive guard unpins the page dirty before releasing the latch, so no
+   * flush can see the change without the dirty flag. Dropping an empty guard does nothing
+   */
+  void Drop();
+
+  [[nodiscard]] auto IsValid() const -> bool { return frame_ != nullptr; }
+
+  [[nodiscard]] auto IsExclusive() const -> bool { return exclusive_; }
+
+  /**
+   * @return the page, it must not be modified through a shared guard
+   */
+  [[nodiscard]] auto GetPage() const -> Page * { return frame_->GetPage(); }
+
+  [[nodiscard]] auto GetData() const -> char * { return frame_->GetPage()->GetData(); }
+
+  [[nodiscard]] auto GetFileId() const -> file_id_t { return fid_; }
+
+  [[nodiscard]] auto GetPageId() const -> page_id_t { return pid_; }
+
+protected:
+  /**
+   * Take the latch of the pinned frame, blocks until no conflicting guard holds it
+   */
+  PageGuard(BufferPoolManager *bpm, file_id_t fid, page_id_t pid, Frame *frame, bool exclusive);
+
+private:
+  BufferPoolManager *bpm_{nullptr};
+  file_id_t          fid_{INVALID_FILE_ID};
+  page_id_t          pid_{INVALID_PAGE_ID};
+  Frame             *frame_{nullptr};
+  bool               exclusive_{false};
+};
+
+/**
+ * Shared access to a page, readers of the same page never block each other
+ */
+class ReadPageGuard : public PageGuard
+{
+public:
+  ReadPageGuard() = default;
+
+  ReadPageGuard(BufferPoolManager *bpm, file_id_t fid, page_id_t pid, Frame *frame)
+      : PageGuard(bpm, fid, pid, frame, false)
+  {}
+};
+
+/**
+ * Exclusive access to a page, the page is marked dirty when the guard is dropped
+ */
+class WritePageGuard : public PageGuard
+{
+public:
+  WritePageGuard() = default;
+
+  WritePageGuard(BufferPoolManager *bpm, file_id_t fid, page_id_t pid, Frame *frame)
+      : PageGuard(bpm, fid, pid, frame, true)
+  {}
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_PAGE_GUARD_H
@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "page_region.h"
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "../../../common/error.h"
+
+namespace wsdb {
+
+PageRegion::PageRegion(size_t num_pages) : num_pages_(num_pages)
+{
+  size_t bytes = (num_pages_ * sizeof(Page) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+  map_addr_ = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (map_addr_ != MAP_FAILED) {
+    map_size_   = bytes;
+    huge_pages_ = true;
+  }
+#endif
+  if (!huge_pages_) {
+    // no reserved huge pages, over-map by one huge page so that the region can start at a huge page boundary
+    map_size_ = bytes + HUGE_PAGE_SIZE;
+    map_addr_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map_addr_ == MAP_FAILED) {
+      WSDB_FETAL(fmt::format("Map buffer pool of {} bytes failed: {}", map_size_, strerror(errno)));
+    }
+  }
+  auto addr = reinterpret_cast<uintptr_t>(map_addr_);
+  addr      = (addr + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#ifdef MADV_HUGEPAGE
+  if (!huge_pages_) {
+    // transparent huge pages may be disabled, the region is still usable with normal pages
+    madvise(reinterpret_cast<void *>(addr), bytes, MADV_HUGEPAGE);
+  }
+#endif
+  pages_ = reinterpret_cast<Page *>(addr);
+  for (size_t i = 0; i < num_pages_; i++) {
+    new (pages_ + i) Page();
+  }
+}
+
+PageRegion::~PageRegion()
+{
+  for (size_t i = 0; i < num_pages_; i++) {
+    pages_[i].~Page();
+  }
+  munmap(map_addr_, map_size_);
+}
+
+}  // namespace wsdb
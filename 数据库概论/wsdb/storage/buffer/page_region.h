@@ -0,0 +1,68 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_PAGE_REGION_H
+#define WSDB_PAGE_REGION_H
+
+#include <cstddef>
+#include "../../../common/micro.h"
+#include "common/page.h"
+
+namespace wsdb {
+
+// huge page size of x86-64 and aarch64 with 4K base pages
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * The pages of the whole buffer pool, allocated as one contiguous anonymous mapping instead of one heap object per
+ * frame, so that a pool of several GB is covered by a few thousand TLB entries rather than a million.
+ * 1. try explicitly reserved huge pages (MAP_HUGETLB)
+ * 2. else map normal pages aligned to HUGE_PAGE_SIZE and ask for transparent huge pages (MADV_HUGEPAGE)
+ * both are hints, the pool works the same on a system that supports neither
+ */
+class PageRegion
+{
+public:
+  explicit PageRegion(size_t num_pages);
+
+  ~PageRegion();
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(PageRegion)
+
+  [[nodiscard]] auto GetPage(size_t idx) -> Page * { return pages_ + idx; }
+
+  [[nodiscard]] auto GetPageCount() const -> size_t { return num_pages_; }
+
+  /**
+   * @return true if the region is backed by explicitly reserved huge pages
+   */
+  [[nodiscard]] auto UsesHugePages() const -> bool { return huge_pages_; }
+
+private:
+  Page  *pages_{nullptr};
+  size_t num_pages_;
+  void  *map_addr_{nullptr};  // the mapping may start before pages_ to align it
+  size_t map_size_{0};
+  bool   huge_pages_{false};
+};
+
+DEFINE_UNIQUE_PTR(PageRegion);
+
+}  // namespace wsdb
+
+#endif  // WSDB_PAGE_REGION_H
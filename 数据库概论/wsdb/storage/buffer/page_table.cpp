@@ -0,0 +1,126 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "page_table.h"
+#include <algorithm>
+#include <bit>
+
+#include "../../../common/error.h"
+
+namespace wsdb {
+
+PageTable::PageTable(size_t max_entries) : max_entries_(max_entries)
+{
+  size_t capacity = std::bit_ceil(std::max<size_t>(max_entries_ * 2, 8));
+  slots_.resize(capacity);
+  heads_.resize(capacity);
+  links_.resize(max_entries_);
+  mask_ = capacity - 1;
+}
+
+auto PageTable::Find(const fid_pid_t &key) const -> frame_id_t { return slots_[Probe(slots_, key.Pack())].frame_id_; }
+
+void PageTable::Insert(const fid_pid_t &key, frame_id_t frame_id)
+{
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_entries_, fmt::format("frame id out of range: {}", frame_id));
+  uint64_t packed = key.Pack();
+  Slot    &slot   = slots_[Probe(slots_, packed)];
+  if (slot.frame_id_ == INVALID_FRAME_ID) {
+    WSDB_ASSERT(size_ < max_entries_, fmt::format("page table is full: {} entries", size_));
+    size_++;
+  } else {
+    Unlink(key.fid, slot.frame_id_);
+  }
+  slot.key_      = packed;
+  slot.frame_id_ = frame_id;
+  Link(key, frame_id);
+}
+
+auto PageTable::Erase(const fid_pid_t &key) -> bool
+{
+  size_t hole = Probe(slots_, key.Pack());
+  if (slots_[hole].frame_id_ == INVALID_FRAME_ID) {
+    return false;
+  }
+  Unlink(key.fid, slots_[hole].frame_id_);
+  EraseSlot(slots_, hole);
+  size_--;
+  return true;
+}
+
+auto PageTable::GetProbeLength(const fid_pid_t &key) const -> size_t
+{
+  return ((Probe(slots_, key.Pack()) - GetHome(key.Pack())) & mask_) + 1;
+}
+
+auto PageTable::Probe(const std::vector<Slot> &slots, uint64_t key) const -> size_t
+{
+  size_t idx = GetHome(key);
+  while (slots[idx].frame_id_ != INVALID_FRAME_ID && slots[idx].key_ != key) {
+    idx = (idx + 1) & mask_;
+  }
+  return idx;
+}
+
+void PageTable::EraseSlot(std::vector<Slot> &slots, size_t hole)
+{
+  // move back every following entry of the cluster that would no longer be reachable from its home slot
+  for (size_t cur = (hole + 1) & mask_; slots[cur].frame_id_ != INVALID_FRAME_ID; cur = (cur + 1) & mask_) {
+    size_t home = GetHome(slots[cur].key_);
+    // the entry stays if its home lies cyclically in (hole, cur]
+    bool reachable = hole <= cur ? (hole < home && home <= cur) : (hole < home || home <= cur);
+    if (!reachable) {
+      slots[hole] = slots[cur];
+      hole        = cur;
+    }
+  }
+  slots[hole] = Slot{};
+}
+
+void PageTable::Link(const fid_pid_t &key, frame_id_t frame_id)
+{
+  uint64_t file_key = FileKey(key.fid);
+  Slot    &head     = heads_[Probe(heads_, file_key)];
+  links_[frame_id]  = {key.pid, INVALID_FRAME_ID, head.frame_id_};
+  if (head.frame_id_ != INVALID_FRAME_ID) {
+    links_[head.frame_id_].prev_ = frame_id;
+  }
+  head.key_      = file_key;
+  head.frame_id_ = frame_id;
+}
+
+void PageTable::Unlink(file_id_t fid, frame_id_t frame_id)
+{
+  FileLink &link = links_[frame_id];
+  if (link.next_ != INVALID_FRAME_ID) {
+    links_[link.next_].prev_ = link.prev_;
+  }
+  if (link.prev_ != INVALID_FRAME_ID) {
+    links_[link.prev_].next_ = link.next_;
+  } else {
+    size_t head = Probe(heads_, FileKey(fid));
+    if (link.next_ != INVALID_FRAME_ID) {
+      heads_[head].frame_id_ = link.next_;
+    } else {
+      EraseSlot(heads_, head);
+    }
+  }
+  link = FileLink{};
+}
+
+}  // namespace wsdb
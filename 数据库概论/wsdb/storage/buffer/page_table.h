@@ -0,0 +1,197 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_PAGE_TABLE_H
+#define WSDB_PAGE_TABLE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../../../common/micro.h"
+#include "common/types.h"
+
+namespace wsdb {
+struct fid_pid_t
+{
+  file_id_t fid;
+  page_id_t pid;
+
+  bool operator==(const fid_pid_t &rhs) const { return fid == rhs.fid && pid == rhs.pid; }
+
+  /** @return fid in the high 32 bits and pid in the low 32 bits */
+  [[nodiscard]] auto Pack() const -> uint64_t
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(fid)) << 32) | static_cast<uint32_t>(pid);
+  }
+
+  [[nodiscard]] static auto Unpack(uint64_t key) -> fid_pid_t
+  {
+    return {static_cast<file_id_t>(key >> 32), static_cast<page_id_t>(static_cast<uint32_t>(key))};
+  }
+};
+
+/**
+ * The finalizer of splitmix64, every bit of the packed key affects every bit of the hash, so keys that differ only in
+ * a few low bits, e.g. consecutive pages of a file, are spread over the whole table
+ */
+inline auto HashPageKey(uint64_t key) -> uint64_t
+{
+  key ^= key >> 30;
+  key *= 0xBF58476D1CE4E5B9ULL;
+  key ^= key >> 27;
+  key *= 0x94D049BB133111EBULL;
+  key ^= key >> 31;
+  return key;
+}
+}  // namespace wsdb
+
+namespace std {
+template <>
+struct hash<wsdb::fid_pid_t>
+{
+  size_t operator()(const wsdb::fid_pid_t &fp) const { return wsdb::HashPageKey(fp.Pack()); }
+};
+}  // namespace std
+
+namespace wsdb {
+
+/**
+ * Page table of a buffer pool shard, mapping (fid, pid) to the frame holding the page.
+ * It is an open addressing hash table with linear probing over a flat array of (packed key, frame id) slots, a lookup
+ * usually touches a single cache line and never allocates. The table holds at most max_entries keys and is sized to
+ * twice that, so it never grows and the probe sequences stay short. Erase shifts the following entries back instead of
+ * leaving tombstones.
+ * The frames holding pages of the same file are also linked into a doubly linked list, whose links are kept per frame
+ * id and whose heads live in a second table of the same layout keyed by the file, so whole-file operations only visit
+ * the frames of the file. Both are updated by Insert and Erase in O(1) and never allocate either.
+ * Frame ids must be below max_entries.
+ * Not thread safe, it is protected by the latch of the shard
+ */
+class PageTable
+{
+public:
+  explicit PageTable(size_t max_entries);
+
+  ~PageTable() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(PageTable)
+
+  /**
+   * @return the frame holding the page, INVALID_FRAME_ID if the page is not in the table
+   */
+  [[nodiscard]] auto Find(const fid_pid_t &key) const -> frame_id_t;
+
+  [[nodiscard]] auto Contains(const fid_pid_t &key) const -> bool { return Find(key) != INVALID_FRAME_ID; }
+
+  /**
+   * Map the page to the frame, overwriting the old mapping of the page if any
+   */
+  void Insert(const fid_pid_t &key, frame_id_t frame_id);
+
+  /**
+   * @return true if the page was in the table
+   */
+  auto Erase(const fid_pid_t &key) -> bool;
+
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+
+  /**
+   * @return the number of slots a lookup of the key visits, used by the benchmark to measure collisions
+   */
+  [[nodiscard]] auto GetProbeLength(const fid_pid_t &key) const -> size_t;
+
+  /**
+   * Call f(pid, frame_id) for every page of the file in the table, in no particular order. The table must not be
+   * modified by f
+   */
+  template <typename F>
+  void ForEachOfFile(file_id_t fid, F &&f) const
+  {
+    size_t head = Probe(heads_, FileKey(fid));
+    for (frame_id_t cur = heads_[head].frame_id_; cur != INVALID_FRAME_ID; cur = links_[cur].next_) {
+      f(links_[cur].pid_, cur);
+    }
+  }
+
+  /**
+   * Call f(key, frame_id) for every entry, the table must not be modified by f
+   */
+  template <typename F>
+  void ForEach(F &&f) const
+  {
+    for (const auto &slot : slots_) {
+      if (slot.frame_id_ != INVALID_FRAME_ID) {
+        f(fid_pid_t::Unpack(slot.key_), slot.frame_id_);
+      }
+    }
+  }
+
+private:
+  struct Slot
+  {
+    uint64_t   key_{0};
+    frame_id_t frame_id_{INVALID_FRAME_ID};  // INVALID_FRAME_ID if the slot is empty
+  };
+
+  /**
+   * Links of a frame in the list of its file
+   */
+  struct FileLink
+  {
+    page_id_t  pid_{INVALID_PAGE_ID};
+    frame_id_t prev_{INVALID_FRAME_ID};
+    frame_id_t next_{INVALID_FRAME_ID};
+  };
+
+  /** @return the key of the list head of the file, no page has INVALID_PAGE_ID */
+  [[nodiscard]] static auto FileKey(file_id_t fid) -> uint64_t { return fid_pid_t{fid, INVALID_PAGE_ID}.Pack(); }
+
+  [[nodiscard]] auto GetHome(uint64_t key) const -> size_t { return HashPageKey(key) & mask_; }
+
+  /**
+   * @return the slot of the table (slots_ or heads_) holding the key, or the empty slot ending its probe sequence
+   */
+  [[nodiscard]] auto Probe(const std::vector<Slot> &slots, uint64_t key) const -> size_t;
+
+  /**
+   * Empty the occupied slot of the table (slots_ or heads_)
+   */
+  void EraseSlot(std::vector<Slot> &slots, size_t hole);
+
+  /**
+   * Add the frame to the front of the list of the file
+   */
+  void Link(const fid_pid_t &key, frame_id_t frame_id);
+
+  /**
+   * Remove the frame from the list of the file, the head is dropped with the last frame
+   */
+  void Unlink(file_id_t fid, frame_id_t frame_id);
+
+private:
+  std::vector<Slot>     slots_;
+  std::vector<Slot>     heads_;  // FileKey(fid) -> first frame of the list of the file
+  std::vector<FileLink> links_;  // frame id -> links of the frame
+  size_t                mask_;
+  size_t                max_entries_;
+  size_t                size_{0};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_PAGE_TABLE_H
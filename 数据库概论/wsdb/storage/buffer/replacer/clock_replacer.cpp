@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "clock_replacer.h"
+#include "../common/error.h"
+
+namespace wsdb {
+
+ClockReplacer::ClockReplacer(size_t num_frames)
+    : states_(num_frames, UNTRACKED), ref_bits_(num_frames, 0), max_size_(num_frames)
+{}
+
+auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (cur_size_ == 0) {
+    return false;
+  }
+  for (size_t step = 0; step < 2 * max_size_; step++) {
+    size_t cur = hand_;
+    hand_      = (hand_ + 1) % max_size_;
+    if (states_[cur] != EVICTABLE) {
+      continue;
+    }
+    if (ref_bits_[cur] != 0) {
+      ref_bits_[cur] = 0;
+      continue;
+    }
+    states_[cur] = UNTRACKED;
+    cur_size_--;
+    *frame_id = static_cast<frame_id_t>(cur);
+    return true;
+  }
+  WSDB_FETAL("ClockReplacer: evictable frame not found");
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_size_, fmt::format("frame id out of range: {}", frame_id));
+
+  if (states_[frame_id] == EVICTABLE) {
+    cur_size_--;
+  }
+  states_[frame_id]   = PINNED;
+  ref_bits_[frame_id] = 1;
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  if (static_cast<size_t>(frame_id) >= max_size_ || states_[frame_id] == UNTRACKED) {
+    WSDB_THROW(WSDB_EXCEPTION_EMPTY, "not exist");
+  }
+  if (states_[frame_id] == PINNED) {
+    states_[frame_id] = EVICTABLE;
+    cur_size_++;
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_size_, fmt::format("frame id out of range: {}", frame_id));
+
+  if (states_[frame_id] == EVICTABLE) {
+    cur_size_--;
+  }
+  states_[frame_id]   = UNTRACKED;
+  ref_bits_[frame_id] = 0;
+}
+
+auto ClockReplacer::Size() -> size_t
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  return cur_size_;
+}
+
+auto ClockReplacer::GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t>
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  std::vector<frame_id_t> candidates;
+  for (uint8_t ref_bit : {0, 1}) {
+    for (size_t step = 0; step < max_size_ && candidates.size() < max_num; step++) {
+      size_t cur = (hand_ + step) % max_size_;
+      if (states_[cur] == EVICTABLE && ref_bits_[cur] == ref_bit) {
+        candidates.push_back(static_cast<frame_id_t>(cur));
+      }
+    }
+  }
+  return candidates;
+}
+
+}  // namespace wsdb
@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_CLOCK_REPLACER_H
+#define WSDB_CLOCK_REPLACER_H
+
+#include <mutex>  // NOLINT
+#include <vector>
+#include "replacer.h"
+
+namespace wsdb {
+
+/**
+ * ClockReplacer approximates LRU with a reference bit per frame and a clock hand sweeping over the frames.
+ * Pin and Unpin only flip per-frame flags, there is no list manipulation on the hit path.
+ */
+class ClockReplacer : public Replacer
+{
+public:
+  explicit ClockReplacer(size_t num_frames);
+
+  ~ClockReplacer() override = default;
+
+  /**
+   * Sweep the clock hand from its last position
+   * 1. skip the frames that are not evictable
+   * 2. if the reference bit of an evictable frame is set, clear it and give the frame a second chance
+   * 3. else the frame is the victim
+   * two rounds are enough to find a victim if there is any evictable frame
+   * @param frame_id
+   * @return true if a victim frame was found, false otherwise
+   */
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  /**
+   * Set the reference bit and mark the frame not evictable
+   * @param frame_id
+   */
+  void Pin(frame_id_t frame_id) override;
+
+  /**
+   * Mark the frame evictable, the frame must have been pinned before
+   * @param frame_id
+   */
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  /**
+   * Evictable frames with the reference bit cleared from the hand on, then those with the bit set
+   * @param max_num
+   * @return
+   */
+  auto GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t> override;
+
+private:
+  enum FrameState : uint8_t
+  {
+    UNTRACKED = 0,
+    PINNED,
+    EVICTABLE,
+  };
+
+  std::mutex latch_;
+  // state and reference bit of each frame, uint8_t instead of vector<bool> to avoid bit manipulation
+  std::vector<FrameState> states_;
+  std::vector<uint8_t>    ref_bits_;
+  size_t                  hand_{0};
+  size_t                  cur_size_{0};  // number of evictable frames
+  size_t                  max_size_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_CLOCK_REPLACER_H
@@ -1,120 +1,151 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#ifndef WSDB_LRU_K_REPLACER_H
-#define WSDB_LRU_K_REPLACER_H
-#include <list>
-#include <mutex>
-#include <unordered_map>
-#include "replacer.h"
-#include "../common/error.h"
-
-namespace wsdb {
-
-class LRUKReplacer : public Replacer
-{
-public:
-  explicit LRUKReplacer(size_t k);
-
-  ~LRUKReplacer() override = default;
-
-  auto Victim(frame_id_t *frame_id) -> bool override;
-
-  void Pin(frame_id_t frame_id) override;
-
-  void Unpin(frame_id_t frame_id) override;
-
-  auto Size() -> size_t override;
-
-private:
-  class LRUKNode
-  {
-  public:
-    LRUKNode() = default;
-
-    explicit LRUKNode(frame_id_t fid, size_t k) : fid_(fid), k(k), is_evictable_(false) {}
-
-    void AddHistory(timestamp_t ts) {
-      history_.push_back(ts);
-      if(history_.size() > k) {
-        history_.pop_front();
-      }
-    }
-
-    /**
-     * Get the distance between the current timestamp and the k-th timestamp in the history,
-     * think: why return type is unsigned long long?
-     * @param cur_ts
-     * @return
-     */
-    auto GetBackwardKDistance(timestamp_t cur_ts) -> unsigned long long
-    {
-      //cur_ts = 15, k = 3 --> 15 - 4 = 11
-      //cur_ts = 6, k = 3 --> +inf
-      if(history_.size() < k) return std::numeric_limits<unsigned long long>::max();
-      // int i = 0;
-      // for(auto it = history_.rbegin(); it != history_.rend(); it++) {
-      //   if(*it < cur_ts) {
-      //     i += 1;
-      //   }
-      //   if(i == k) {
-      //     return cur_ts - *it;
-      //   }
-      // }
-      // return std::numeric_limits<unsigned long long>::max();
-      return cur_ts - history_.front();
-    }
-
-    [[nodiscard]] auto IsEvictable() const -> bool {
-      return is_evictable_;
-    }
-
-    auto SetEvictable(bool set_evictable) -> void {
-      is_evictable_ = set_evictable;
-    }
-
-    [[nodiscard]] auto GetFirstTimeStamp() const -> timestamp_t {
-      return history_.front();
-    }
-
-    auto ClearHistory() -> void {
-      history_.clear();
-    }
-
-
-  private:
-    std::list<timestamp_t> history_;
-    frame_id_t             fid_{INVALID_FRAME_ID};
-    size_t                 k{};
-    bool                   is_evictable_{};
-  };
-
-private:
-  std::unordered_map<frame_id_t, LRUKNode> node_store_;  // frame_id -> LRUKNode
-  size_t                                   cur_ts_{0};
-  size_t                                   cur_size_{0};  // number of evictable frames
-  size_t                                   max_size_;     // maximum number of frames that can be stored
-  size_t                                   k_;            // k for LRU-k
-  std::mutex                               latch_;        // mutex for curr_size_, node_store_, and curr_timestamp_
-};
-}  // namespace wsdb
-
-#endif  // WSDB_LRU_K_REPLACER_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#ifndef WSDB_LRU_K_REPLACER_H
+#define WSDB_LRU_K_REPLACER_H
+#include <mutex>
+#include <set>
+#include <vector>
+#include "replacer.h"
+#include "../common/error.h"
+
+namespace wsdb {
+
+/**
+ * LRUKReplacer evicts the frame whose backward k-distance is the largest, frames with less than k accesses have
+ * +inf distance and the one with the earliest first access is evicted first.
+ * Evictable frames are kept in two ordered sets so that Victim, Pin and Unpin are O(log n) and never scan the frames:
+ * - less_k_set_: frames with less than k accesses, ordered by the first access
+ * - k_set_: frames with k accesses, ordered by the k-th most recent access, i.e. by decreasing k-distance
+ */
+class LRUKReplacer : public Replacer
+{
+public:
+  explicit LRUKReplacer(size_t k);
+
+  LRUKReplacer(size_t num_frames, size_t k);
+
+  ~LRUKReplacer() override = default;
+
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  /**
+   * Start a new access history for the page loaded into the frame, the accesses of the page it held before must not
+   * count for the new one, however the frame left the buffer pool
+   * @param frame_id
+   * @param page_key
+   */
+  void SetPage(frame_id_t frame_id, uint64_t page_key) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t> override;
+
+private:
+  /**
+   * The access history of a frame is a ring buffer holding the last k timestamps,
+   * the buffers of all frames are slices of history_buf_
+   */
+  class LRUKNode
+  {
+  public:
+    LRUKNode() = default;
+
+    void AddHistory(timestamp_t *history, size_t k, timestamp_t ts)
+    {
+      if (count_ < k) {
+        history[(head_ + count_) % k] = ts;
+        count_++;
+      } else {
+        // overwrite the oldest timestamp
+        history[head_] = ts;
+        head_          = (head_ + 1) % k;
+      }
+    }
+
+    /**
+     * Get the earliest timestamp in the history, it is the first access if the frame has less than k accesses,
+     * otherwise the k-th most recent access that determines the backward k-distance
+     */
+    [[nodiscard]] auto GetFirstTimeStamp(const timestamp_t *history) const -> timestamp_t
+    {
+      return count_ == 0 ? 0 : history[head_];
+    }
+
+    [[nodiscard]] auto HasKHistory(size_t k) const -> bool { return count_ == k; }
+
+    [[nodiscard]] auto IsEvictable() const -> bool { return is_evictable_; }
+
+    auto SetEvictable(bool set_evictable) -> void { is_evictable_ = set_evictable; }
+
+    [[nodiscard]] auto IsTracked() const -> bool { return is_tracked_; }
+
+    auto SetTracked(bool tracked) -> void { is_tracked_ = tracked; }
+
+    auto ClearHistory() -> void
+    {
+      head_  = 0;
+      count_ = 0;
+    }
+
+  private:
+    uint32_t head_{0};   // index of the oldest timestamp in the ring buffer
+    uint32_t count_{0};  // number of valid timestamps
+    bool     is_evictable_{false};
+    bool     is_tracked_{false};  // whether the frame has ever been pinned
+  };
+
+  using EvictKey = std::pair<timestamp_t, frame_id_t>;
+
+  /// sub procedures, should be called with latch held
+
+  auto GetHistory(frame_id_t frame_id) -> timestamp_t * { return &history_buf_[static_cast<size_t>(frame_id) * k_]; }
+
+  auto GetEvictSet(frame_id_t frame_id) -> std::set<EvictKey> &
+  {
+    return node_store_[frame_id].HasKHistory(k_) ? k_set_ : less_k_set_;
+  }
+
+  auto GetEvictKey(frame_id_t frame_id) -> EvictKey
+  {
+    return {node_store_[frame_id].GetFirstTimeStamp(GetHistory(frame_id)), frame_id};
+  }
+
+private:
+  std::vector<LRUKNode>    node_store_;   // frame_id -> LRUKNode
+  std::vector<timestamp_t> history_buf_;  // max_size_ * k_ timestamps
+  std::set<EvictKey>       less_k_set_;   // evictable frames with +inf k-distance
+  std::set<EvictKey>       k_set_;        // evictable frames with k accesses
+  size_t                   cur_ts_{0};
+  size_t                   cur_size_{0};  // number of evictable frames
+  size_t                   max_size_;     // maximum number of frames that can be stored
+  size_t                   k_;            // k for LRU-k
+  std::mutex               latch_;        // mutex for curr_size_, node_store_, and curr_timestamp_
+};
+}  // namespace wsdb
+
+#endif  // WSDB_LRU_K_REPLACER_H
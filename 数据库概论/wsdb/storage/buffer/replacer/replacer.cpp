@@ -1,22 +1,45 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#include "replacer.h"
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#include "replacer.h"
+#include "lru_replacer.h"
+#include "lru_k_replacer.h"
+#include "clock_replacer.h"
+#include "two_queue_replacer.h"
+#include "../common/error.h"
+
+namespace wsdb {
+
+auto Replacer::Create(const std::string &policy, size_t num_frames, size_t lru_k) -> std::unique_ptr<Replacer>
+{
+  if (policy == "LRUReplacer") {
+    return std::make_unique<LRUReplacer>(num_frames);
+  } else if (policy == "LRUKReplacer") {
+    return std::make_unique<LRUKReplacer>(num_frames, lru_k);
+  } else if (policy == "ClockReplacer") {
+    return std::make_unique<ClockReplacer>(num_frames);
+  } else if (policy == "TwoQueueReplacer") {
+    return std::make_unique<TwoQueueReplacer>(num_frames);
+  }
+  WSDB_THROW(WSDB_NOT_IMPLEMENTED, fmt::format("unknown replacer: {}", policy));
+}
+
+}  // namespace wsdb
@@ -1,64 +1,99 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#ifndef NJU_DBCOURSE_REPLACER_H
-#define NJU_DBCOURSE_REPLACER_H
-
-#include "common/types.h"
-
-namespace wsdb {
-
-/**
- * Replacer is an abstract class that tracks page usage.
- */
-class Replacer
-{
-public:
-  Replacer()          = default;
-  virtual ~Replacer() = default;
-
-  /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
-   * @return true if a victim frame was found, false otherwise
-   */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
-
-  /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
-   */
-  virtual void Pin(frame_id_t frame_id) = 0;
-
-  /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
-   */
-  virtual void Unpin(frame_id_t frame_id) = 0;
-
-  /** @return the number of elements in the replacer that can be victimized */
-  virtual auto Size() -> size_t = 0;
-
-};
-
-}  // namespace wsdb
-
-#endif  // NJU_DBCOURSE_REPLACER_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#ifndef NJU_DBCOURSE_REPLACER_H
+#define NJU_DBCOURSE_REPLACER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/types.h"
+
+namespace wsdb {
+
+/**
+ * Replacer is an abstract class that tracks page usage.
+ */
+class Replacer
+{
+public:
+  Replacer()          = default;
+  virtual ~Replacer() = default;
+
+  /**
+   * Remove the victim frame as defined by the replacement policy.
+   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * @return true if a victim frame was found, false otherwise
+   */
+  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Pins a frame, indicating that it should not be victimized until it is unpinned.
+   * @param frame_id the id of the frame to pin
+   */
+  virtual void Pin(frame_id_t frame_id) = 0;
+
+  /**
+   * Unpins a frame, indicating that it can now be victimized.
+   * @param frame_id the id of the frame to unpin
+   */
+  virtual void Unpin(frame_id_t frame_id) = 0;
+
+  /**
+   * Stop tracking a frame whose page is dropped from the buffer pool without being victimized, e.g. a deleted page.
+   * The frame goes to the free list and is tracked again from its next page on, like a victimized frame
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of elements in the replacer that can be victimized */
+  virtual auto Size() -> size_t = 0;
+
+  /**
+   * Tell the replacer which page is loaded into the frame, called before the first Pin of the page.
+   * Policies that remember evicted pages (e.g. 2Q) use it, others just ignore it
+   * @param frame_id the id of the frame
+   * @param page_key (fid, pid) of the page packed into 64 bits
+   */
+  virtual void SetPage(frame_id_t frame_id, uint64_t page_key) {}
+
+  /**
+   * Peek the evictable frames in the order they are likely to be victimized, without changing the replacer state.
+   * Used by the page cleaner to write dirty pages back before they are evicted
+   * @param max_num maximum number of frames to return
+   * @return frame ids, the first one is the next victim
+   */
+  virtual auto GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t> = 0;
+
+  /**
+   * Create a replacer by its policy name, the policy can be chosen at runtime
+   * @param policy LRUReplacer, LRUKReplacer, ClockReplacer or TwoQueueReplacer
+   * @param num_frames number of frames tracked by the replacer
+   * @param lru_k k used by LRUKReplacer
+   * @return the replacer, throw WSDB_NOT_IMPLEMENTED if the policy is unknown
+   */
+  static auto Create(const std::string &policy, size_t num_frames, size_t lru_k) -> std::unique_ptr<Replacer>;
+
+};
+
+}  // namespace wsdb
+
+#endif  // NJU_DBCOURSE_REPLACER_H
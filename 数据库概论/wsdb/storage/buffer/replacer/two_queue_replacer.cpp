@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "two_queue_replacer.h"
+#include <algorithm>
+#include "../common/error.h"
+
+namespace wsdb {
+
+// sizes recommended by the 2Q paper: Kin = 25% and Kout = 50% of the buffer
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : nodes_(num_frames), kin_(std::max<size_t>(num_frames / 4, 1)), kout_(std::max<size_t>(num_frames / 2, 1)),
+      max_size_(num_frames)
+{}
+
+auto TwoQueueReplacer::Victim(frame_id_t *frame_id) -> bool
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (cur_size_ == 0) {
+    return false;
+  }
+  if ((a1in_size_ > kin_ && !a1in_.empty()) || am_.empty()) {
+    *frame_id = EvictFrom(a1in_);
+  } else {
+    *frame_id = EvictFrom(am_);
+  }
+  return true;
+}
+
+void TwoQueueReplacer::SetPage(frame_id_t frame_id, uint64_t page_key)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_size_, fmt::format("frame id out of range: {}", frame_id));
+
+  auto &node = nodes_[frame_id];
+  if (node.evictable_) {
+    // a frame dropped from the buffer pool without being victimized
+    (node.queue_ == A1IN ? a1in_ : am_).erase(node.pos_);
+    node.evictable_ = false;
+    cur_size_--;
+  }
+  if (node.queue_ == A1IN) {
+    a1in_size_--;
+  }
+  node.page_key_ = page_key;
+  auto it        = a1out_map_.find(page_key);
+  if (it != a1out_map_.end()) {
+    // the page comes back soon after being evicted from A1in, it is hot
+    a1out_.erase(it->second);
+    a1out_map_.erase(it);
+    node.queue_ = AM;
+  } else {
+    node.queue_ = A1IN;
+    a1in_size_++;
+  }
+}
+
+void TwoQueueReplacer::Pin(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_size_, fmt::format("frame id out of range: {}", frame_id));
+
+  auto &node = nodes_[frame_id];
+  if (node.queue_ == NONE) {
+    // no page is set, e.g. used without a buffer pool, treat the frame as a new page
+    node.queue_ = A1IN;
+    a1in_size_++;
+  }
+  if (node.evictable_) {
+    (node.queue_ == A1IN ? a1in_ : am_).erase(node.pos_);
+    node.evictable_ = false;
+    cur_size_--;
+  }
+}
+
+void TwoQueueReplacer::Unpin(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  if (static_cast<size_t>(frame_id) >= max_size_ || nodes_[frame_id].queue_ == NONE) {
+    WSDB_THROW(WSDB_EXCEPTION_EMPTY, "not exist");
+  }
+  auto &node = nodes_[frame_id];
+  if (!node.evictable_) {
+    auto &queue = node.queue_ == A1IN ? a1in_ : am_;
+    node.pos_   = queue.insert(queue.end(), frame_id);
+    node.evictable_ = true;
+    cur_size_++;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id)
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  WSDB_ASSERT(static_cast<size_t>(frame_id) < max_size_, fmt::format("frame id out of range: {}", frame_id));
+
+  auto &node = nodes_[frame_id];
+  if (node.evictable_) {
+    (node.queue_ == A1IN ? a1in_ : am_).erase(node.pos_);
+    node.evictable_ = false;
+    cur_size_--;
+  }
+  if (node.queue_ == A1IN) {
+    a1in_size_--;
+  }
+  node.queue_ = NONE;
+}
+
+auto TwoQueueReplacer::Size() -> size_t
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  return cur_size_;
+}
+
+auto TwoQueueReplacer::GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t>
+{
+  std::lock_guard<std::mutex> lock(latch_);
+
+  std::vector<frame_id_t> candidates;
+  size_t                  a1in_over = a1in_size_ > kin_ ? a1in_size_ - kin_ : 0;
+  auto                    a1in_it   = a1in_.begin();
+  for (; a1in_it != a1in_.end() && a1in_over > 0 && candidates.size() < max_num; ++a1in_it, a1in_over--) {
+    candidates.push_back(*a1in_it);
+  }
+  for (auto it = am_.begin(); it != am_.end() && candidates.size() < max_num; ++it) {
+    candidates.push_back(*it);
+  }
+  for (; a1in_it != a1in_.end() && candidates.size() < max_num; ++a1in_it) {
+    candidates.push_back(*a1in_it);
+  }
+  return candidates;
+}
+
+auto TwoQueueReplacer::EvictFrom(std::list<frame_id_t> &queue) -> frame_id_t
+{
+  frame_id_t frame_id = queue.front();
+  queue.pop_front();
+  auto &node = nodes_[frame_id];
+  if (node.queue_ == A1IN) {
+    a1in_size_--;
+    RememberEvicted(node.page_key_);
+  }
+  node.queue_     = NONE;
+  node.evictable_ = false;
+  cur_size_--;
+  return frame_id;
+}
+
+void TwoQueueReplacer::RememberEvicted(uint64_t page_key)
+{
+  if (a1out_map_.count(page_key) != 0) {
+    return;
+  }
+  a1out_map_[page_key] = a1out_.insert(a1out_.end(), page_key);
+  if (a1out_.size() > kout_) {
+    a1out_map_.erase(a1out_.front());
+    a1out_.pop_front();
+  }
+}
+
+}  // namespace wsdb
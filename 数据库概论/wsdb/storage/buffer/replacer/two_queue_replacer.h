@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_TWO_QUEUE_REPLACER_H
+#define WSDB_TWO_QUEUE_REPLACER_H
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+#include "replacer.h"
+
+namespace wsdb {
+
+/**
+ * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB'94).
+ * - A1in: FIFO of resident pages referenced only once, at most kin_ frames
+ * - A1out: ghost FIFO remembering the keys of pages recently evicted from A1in, at most kout_ keys
+ * - Am: LRU of resident pages referenced again after leaving A1in
+ * A page loaded for the first time goes to A1in, a page loaded again while its key is in A1out goes to Am,
+ * so a single sequential scan only churns A1in and leaves the hot pages in Am alone.
+ * The queues only hold evictable frames, a pinned frame is put back to the tail of its queue when unpinned.
+ */
+class TwoQueueReplacer : public Replacer
+{
+public:
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  ~TwoQueueReplacer() override = default;
+
+  /**
+   * 1. if A1in holds more than kin_ frames, evict the head of A1in and remember its key in A1out
+   * 2. else evict the head of Am
+   * 3. if the chosen queue has no evictable frame, try the other one
+   * @param frame_id
+   * @return true if a victim frame was found, false otherwise
+   */
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void SetPage(frame_id_t frame_id, uint64_t page_key) override;
+
+  /**
+   * Remove the frame from its queue, a frame in Am is re-inserted at the MRU end when unpinned
+   * @param frame_id
+   */
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  /**
+   * Take the frame out of its queue, the key of its page is not remembered in A1out since the page was not evicted
+   * for lack of space
+   * @param frame_id
+   */
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  /**
+   * Frames of A1in beyond kin_, then Am, then the rest of A1in, following the order of Victim
+   * @param max_num
+   * @return
+   */
+  auto GetVictimCandidates(size_t max_num) -> std::vector<frame_id_t> override;
+
+private:
+  enum QueueType : uint8_t
+  {
+    NONE = 0,
+    A1IN,
+    AM,
+  };
+
+  struct FrameNode
+  {
+    QueueType                       queue_{NONE};
+    bool                            evictable_{false};
+    uint64_t                        page_key_{0};
+    std::list<frame_id_t>::iterator pos_;  // position in its queue if evictable
+  };
+
+  /// sub procedures, should be called with latch held
+
+  auto EvictFrom(std::list<frame_id_t> &queue) -> frame_id_t;
+
+  void RememberEvicted(uint64_t page_key);
+
+private:
+  std::mutex                                                latch_;
+  std::vector<FrameNode>                                    nodes_;
+  std::list<frame_id_t>                                     a1in_;
+  std::list<frame_id_t>                                     am_;
+  std::list<uint64_t>                                       a1out_;
+  std::unordered_map<uint64_t, std::list<uint64_t>::iterator> a1out_map_;
+  size_t                                                    a1in_size_{0};  // resident frames in A1in, pinned or not
+  size_t                                                    kin_;
+  size_t                                                    kout_;
+  size_t                                                    cur_size_{0};  // number of evictable frames
+  size_t                                                    max_size_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_TWO_QUEUE_REPLACER_H
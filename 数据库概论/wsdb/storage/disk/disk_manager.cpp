@@ -1,146 +1,644 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#include <filesystem>
-#include <fcntl.h>
-#include <unistd.h>
-#include "disk_manager.h"
-#include "../../common/config.h"
-#include "../../../common/error.h"
-
-namespace wsdb {
-void DiskManager::CreateFile(const std::string &fname)
-{
-  if (FileExists(fname)) {
-    WSDB_THROW(WSDB_FILE_EXISTS, fname);
-  }
-  std::ofstream file(fname);
-  if (!file) {
-    WSDB_FETAL("Create file failed");
-  }
-  file.close();
-}
-
-void DiskManager::DestroyFile(const std::string &fname)
-{
-  if (!FileExists(fname)) {
-    WSDB_THROW(WSDB_FILE_NOT_EXISTS, fname);
-  }
-  int ret = unlink(fname.c_str());
-  if (ret < 0) {
-    WSDB_THROW(WSDB_FILE_DELETE_ERROR, fname);
-  }
-}
-
-auto DiskManager::OpenFile(const std::string &fname) -> file_id_t
-{
-  if (!FileExists(fname))
-    WSDB_THROW(WSDB_FILE_NOT_EXISTS, fname);
-  if (name_fid_map_.find(fname) != name_fid_map_.end()) {
-    WSDB_THROW(WSDB_FILE_REOPEN, fname);
-  } else {
-    int fd = open(fname.c_str(), O_RDWR);
-    if (fd == -1) {
-      WSDB_THROW(WSDB_FILE_NOT_OPEN, fname);
-    }
-    name_fid_map_.insert(std::make_pair(fname, fd));
-    fid_name_map_.insert(std::make_pair(fd, fname));
-    return fd;
-  }
-}
-
-void DiskManager::CloseFile(file_id_t fid)
-{
-  if (fid_name_map_.find(fid) == fid_name_map_.end()) {
-    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("fid: {}", fid));
-  } else {
-    name_fid_map_.erase(fid_name_map_[fid]);
-    fid_name_map_.erase(fid);
-    close(fid);
-  }
-}
-
-void DiskManager::WritePage(file_id_t fid, page_id_t page_id, const char *data)
-{
-  WSDB_ASSERT(fid_name_map_.find(fid) != fid_name_map_.end(), fmt::format("fid: {}", fid));
-  lseek(fid, static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE), SEEK_SET);
-  if (write(fid, data, PAGE_SIZE) != PAGE_SIZE) {
-    WSDB_THROW(
-        WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id));
-  }
-}
-
-void DiskManager::ReadPage(file_id_t fid, page_id_t page_id, char *data)
-{
-  WSDB_ASSERT(fid_name_map_.find(fid) != fid_name_map_.end(), fmt::format("fid: {}", fid));
-  lseek(fid, static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE), SEEK_SET);
-  if (read(fid, data, PAGE_SIZE) < 0) {
-    WSDB_THROW(
-        WSDB_FILE_READ_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id));
-  }
-}
-
-void DiskManager::ReadFile(file_id_t fid, char *data, size_t size, size_t offset, int type)
-{
-  WSDB_ASSERT(fid_name_map_.find(fid) != fid_name_map_.end(), "File not Opened");
-  lseek(fid, static_cast<off_t>(offset), type);
-  if(read(fid, data, size) < 0) {
-    WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("fid: {}", fid));
-  }
-}
-
-void DiskManager::WriteFile(file_id_t fid, const char *data, size_t size, int type)
-{
-  WSDB_ASSERT(fid_name_map_.find(fid) != fid_name_map_.end(), "File not Opened");
-  WSDB_ASSERT(type == SEEK_CUR || type == SEEK_SET || type == SEEK_END, "Invalid Type");
-  lseek(fid, 0, type);
-  if(write(fid, data, size) < 0) {
-    WSDB_THROW(WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}", fid));
-  }
-}
-
-void DiskManager::WriteLog(const std::string &log_file, const std::string &log_string) {}
-
-void DiskManager::ReadLog(const std::string &log_file, std::string &log_string) {}
-
-auto DiskManager::GetFileId(const std::string &fname) -> file_id_t
-{
-  auto it = name_fid_map_.find(fname);
-  if (it != name_fid_map_.end()) {
-    return it->second;
-  } else {
-    return INVALID_FILE_ID;
-  }
-}
-
-auto DiskManager::GetFileName(file_id_t fid) -> std::string
-{
-  auto it = fid_name_map_.find(fid);
-  if (it != fid_name_map_.end()) {
-    return it->second;
-  } else {
-    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("fid: {}", fid));
-  }
-}
-
-auto DiskManager::FileExists(const std::string &fname) -> bool { return std::filesystem::exists(fname); }
-
-}  // namespace wsdb
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#include <filesystem>
+#include <algorithm>
+#include <climits>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "disk_manager.h"
+#include "../../common/config.h"
+#include "../../../common/error.h"
+
+namespace wsdb {
+void DiskManager::CreateFile(const std::string &fname)
+{
+  if (FileExists(fname)) {
+    WSDB_THROW(WSDB_FILE_EXISTS, fname);
+  }
+  std::ofstream file(fname);
+  if (!file) {
+    WSDB_FETAL("Create file failed");
+  }
+  file.close();
+}
+
+void DiskManager::DestroyFile(const std::string &fname)
+{
+  if (!FileExists(fname)) {
+    WSDB_THROW(WSDB_FILE_NOT_EXISTS, fname);
+  }
+  int ret = unlink(fname.c_str());
+  if (ret < 0) {
+    WSDB_THROW(WSDB_FILE_DELETE_ERROR, fname);
+  }
+}
+
+auto DiskManager::OpenFile(const std::string &fname, bool page_file) -> file_id_t
+{
+  if (!FileExists(fname))
+    WSDB_THROW(WSDB_FILE_NOT_EXISTS, fname);
+  std::lock_guard<std::mutex> lock(name_latch_);
+  if (name_fid_map_.find(fname) != name_fid_map_.end()) {
+    WSDB_THROW(WSDB_FILE_REOPEN, fname);
+  }
+  // direct I/O works on whole pages, it needs pages of a multiple of the alignment
+  bool direct = direct_io_ && page_file && PAGE_SIZE % DIRECT_IO_ALIGNMENT == 0;
+  int  fd     = -1;
+#ifdef O_DIRECT
+  if (direct) {
+    fd = open(fname.c_str(), O_RDWR | O_DIRECT);
+    // EINVAL if the file system does not support direct I/O, use the page cache then
+    direct = fd != -1;
+  }
+#else
+  direct = false;
+#endif
+  if (fd == -1) {
+    fd = open(fname.c_str(), O_RDWR);
+  }
+  if (fd == -1) {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fname);
+  }
+  if (static_cast<size_t>(fd) >= FILE_CHUNK_SIZE * FILE_CHUNK_NUM) {
+    close(fd);
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("{}, too many opened files", fname));
+  }
+  auto &chunk = file_chunks_[fd / FILE_CHUNK_SIZE];
+  if (chunk.load(std::memory_order_acquire) == nullptr) {
+    chunk.store(new FileChunk{}, std::memory_order_release);
+  }
+  files_[fd] = std::make_shared<FileEntry>(fname, direct);
+  name_fid_map_.insert(std::make_pair(fname, fd));
+  (*chunk.load(std::memory_order_relaxed))[fd % FILE_CHUNK_SIZE].store(
+      direct ? FILE_OPENED | FILE_DIRECT : FILE_OPENED, std::memory_order_release);
+  return fd;
+}
+
+void DiskManager::CloseFile(file_id_t fid)
+{
+  std::lock_guard<std::mutex> lock(name_latch_);
+  auto                        it = files_.find(fid);
+  if (it == files_.end()) {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("fid: {}", fid));
+  }
+  (*file_chunks_[fid / FILE_CHUNK_SIZE].load(std::memory_order_relaxed))[fid % FILE_CHUNK_SIZE].store(
+      FILE_CLOSED, std::memory_order_release);
+  name_fid_map_.erase(it->second->name_);
+  // a stream I/O still holding the entry frees it when it finishes
+  files_.erase(it);
+  close(fid);
+}
+
+DiskManager::DiskManager(size_t io_depth, bool direct_io)
+    : direct_io_(direct_io), ring_(std::make_unique<IORing>(static_cast<unsigned>(io_depth)))
+{}
+
+DiskManager::~DiskManager()
+{
+  for (auto &chunk : file_chunks_) {
+    delete chunk.load(std::memory_order_relaxed);
+  }
+}
+
+auto DiskManager::GetFileState(file_id_t fid) const -> uint8_t
+{
+  if (fid < 0 || static_cast<size_t>(fid) >= FILE_CHUNK_SIZE * FILE_CHUNK_NUM) {
+    return FILE_CLOSED;
+  }
+  auto *chunk = file_chunks_[fid / FILE_CHUNK_SIZE].load(std::memory_order_acquire);
+  return chunk == nullptr ? FILE_CLOSED : (*chunk)[fid % FILE_CHUNK_SIZE].load(std::memory_order_acquire);
+}
+
+auto DiskManager::GetFileEntry(file_id_t fid) -> std::shared_ptr<FileEntry>
+{
+  std::lock_guard<std::mutex> lock(name_latch_);
+  auto                        it = files_.find(fid);
+  return it == files_.end() ? nullptr : it->second;
+}
+
+auto DiskManager::IsDirectIO(file_id_t fid) const -> bool { return (GetFileState(fid) & FILE_DIRECT) != 0; }
+
+static auto IsAligned(const void *p) -> bool { return reinterpret_cast<uintptr_t>(p) % DIRECT_IO_ALIGNMENT == 0; }
+
+auto DiskManager::AllocAligned(size_t size) -> AlignedBuffer
+{
+  size      = (size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  auto *buf = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, size));
+  if (buf == nullptr) {
+    WSDB_FETAL(fmt::format("Allocate aligned buffer of {} bytes failed", size));
+  }
+  return AlignedBuffer(buf);
+}
+
+auto DiskManager::ReadAt(file_id_t fid, char *data, size_t size, off_t offset, bool direct) -> size_t
+{
+  size_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fid, data + done, size - done, offset + static_cast<off_t>(done));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("fid: {}, offset: {}, {}", fid, offset, strerror(errno)));
+    }
+    if (ret == 0) {
+      // end of file
+      break;
+    }
+    done += static_cast<size_t>(ret);
+    if (direct && done % DIRECT_IO_ALIGNMENT != 0) {
+      break;
+    }
+  }
+  return done;
+}
+
+auto DiskManager::WriteAt(file_id_t fid, const char *data, size_t size, off_t offset) -> bool
+{
+  size_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fid, data + done, size - done, offset + static_cast<off_t>(done));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+void DiskManager::WritePage(file_id_t fid, page_id_t page_id, const char *data)
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  AlignedBuffer bounce;
+  if (IsDirectIO(fid) && !IsAligned(data)) {
+    bounce = AllocAligned(PAGE_SIZE);
+    std::memcpy(bounce.get(), data, PAGE_SIZE);
+    data = bounce.get();
+  }
+  // positional write, the fd offset is shared by all threads working on the file
+  if (!WriteAt(fid, data, PAGE_SIZE, static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE))) {
+    WSDB_THROW(WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, page_id: {}, {}", fid, page_id, strerror(errno)));
+  }
+}
+
+void DiskManager::ReadPage(file_id_t fid, page_id_t page_id, char *data)
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  bool          direct = IsDirectIO(fid);
+  AlignedBuffer bounce;
+  char         *buf = data;
+  if (direct && !IsAligned(data)) {
+    bounce = AllocAligned(PAGE_SIZE);
+    buf    = bounce.get();
+  }
+  auto ret = ReadAt(fid, buf, PAGE_SIZE, static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE), direct);
+  if (buf != data) {
+    std::memcpy(data, buf, ret);
+  }
+  if (ret < PAGE_SIZE) {
+    // the page is not fully on disk yet, e.g. a new page or the header page of a table without pages
+    std::memset(data + ret, 0, PAGE_SIZE - ret);
+  }
+}
+
+void DiskManager::ReadPages(file_id_t fid, page_id_t page_id, const std::vector<char *> &pages)
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  bool direct = IsDirectIO(fid);
+  if (direct && !std::all_of(pages.begin(), pages.end(), IsAligned)) {
+    auto                bounce = AllocAligned(pages.size() * PAGE_SIZE);
+    std::vector<char *> aligned(pages.size());
+    for (size_t i = 0; i < pages.size(); i++) {
+      aligned[i] = bounce.get() + i * PAGE_SIZE;
+    }
+    ReadPages(fid, page_id, aligned);
+    for (size_t i = 0; i < pages.size(); i++) {
+      std::memcpy(pages[i], aligned[i], PAGE_SIZE);
+    }
+    return;
+  }
+  std::vector<iovec> iov(pages.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    iov[i] = {pages[i], PAGE_SIZE};
+  }
+  auto   offset = static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE);
+  size_t done   = 0;  // bytes read
+  while (done < pages.size() * PAGE_SIZE) {
+    size_t  first = done / PAGE_SIZE;
+    size_t  skip  = done % PAGE_SIZE;
+    // resume from the middle of a page after a short read
+    iovec   head  = iov[first];
+    iov[first]    = {static_cast<char *>(head.iov_base) + skip, PAGE_SIZE - skip};
+    int     cnt   = static_cast<int>(std::min<size_t>(pages.size() - first, IOV_MAX));
+    ssize_t ret   = preadv(fid, &iov[first], cnt, offset + static_cast<off_t>(done));
+    iov[first]    = head;
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id + first));
+    }
+    if (ret == 0 || (direct && (done + static_cast<size_t>(ret)) % DIRECT_IO_ALIGNMENT != 0)) {
+      // end of file, a short direct read can not be resumed at an unaligned offset and ends at the end of the file
+      done += static_cast<size_t>(ret);
+      first = done / PAGE_SIZE;
+      skip  = done % PAGE_SIZE;
+      for (size_t i = first; i < pages.size(); i++) {
+        std::memset(pages[i] + (i == first ? skip : 0), 0, PAGE_SIZE - (i == first ? skip : 0));
+      }
+      return;
+    }
+    done += static_cast<size_t>(ret);
+  }
+}
+
+void DiskManager::WritePages(file_id_t fid, page_id_t page_id, const std::vector<const char *> &pages)
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  if (IsDirectIO(fid) && !std::all_of(pages.begin(), pages.end(), IsAligned)) {
+    auto                      bounce = AllocAligned(pages.size() * PAGE_SIZE);
+    std::vector<const char *> aligned(pages.size());
+    for (size_t i = 0; i < pages.size(); i++) {
+      std::memcpy(bounce.get() + i * PAGE_SIZE, pages[i], PAGE_SIZE);
+      aligned[i] = bounce.get() + i * PAGE_SIZE;
+    }
+    WritePages(fid, page_id, aligned);
+    return;
+  }
+  std::vector<iovec> iov(pages.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    iov[i] = {const_cast<char *>(pages[i]), PAGE_SIZE};
+  }
+  auto   offset = static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE);
+  size_t done   = 0;  // bytes written
+  while (done < pages.size() * PAGE_SIZE) {
+    size_t  first = done / PAGE_SIZE;
+    size_t  skip  = done % PAGE_SIZE;
+    // resume from the middle of a page after a short write
+    iovec   head  = iov[first];
+    iov[first]    = {static_cast<char *>(head.iov_base) + skip, PAGE_SIZE - skip};
+    int     cnt   = static_cast<int>(std::min<size_t>(pages.size() - first, IOV_MAX));
+    ssize_t ret   = pwritev(fid, &iov[first], cnt, offset + static_cast<off_t>(done));
+    iov[first]    = head;
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      WSDB_THROW(WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, page_id: {}", fid, page_id + first));
+    }
+    done += static_cast<size_t>(ret);
+  }
+}
+
+auto DiskManager::SubmitReadPages(file_id_t fid, page_id_t page_id, const std::vector<char *> &pages) -> io_ticket_t
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  return SubmitIO(std::make_unique<AsyncIO>(AsyncIO{false, fid, page_id, pages, {}, {}, nullptr, 0, nullptr}));
+}
+
+auto DiskManager::SubmitWritePages(file_id_t fid, page_id_t page_id, const std::vector<const char *> &pages)
+    -> io_ticket_t
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  std::vector<char *> buffers(pages.size());
+  std::transform(pages.begin(), pages.end(), buffers.begin(), [](const char *p) { return const_cast<char *>(p); });
+  return SubmitIO(
+      std::make_unique<AsyncIO>(AsyncIO{true, fid, page_id, std::move(buffers), {}, {}, nullptr, 0, nullptr}));
+}
+
+auto DiskManager::SubmitIO(std::unique_ptr<AsyncIO> io) -> io_ticket_t
+{
+  size_t num_parts = (io->pages_.size() + IOV_MAX - 1) / IOV_MAX;
+  io->iov_.resize(io->pages_.size());
+  if (IsDirectIO(io->fid_) && !std::all_of(io->pages_.begin(), io->pages_.end(), IsAligned)) {
+    io->bounce_ = AllocAligned(io->pages_.size() * PAGE_SIZE);
+    for (size_t i = 0; i < io->pages_.size(); i++) {
+      io->iov_[i] = {io->bounce_.get() + i * PAGE_SIZE, PAGE_SIZE};
+      if (io->write_) {
+        std::memcpy(io->iov_[i].iov_base, io->pages_[i], PAGE_SIZE);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < io->pages_.size(); i++) {
+      io->iov_[i] = {io->pages_[i], PAGE_SIZE};
+    }
+  }
+  for (size_t first = 0; first < io->pages_.size(); first += IOV_MAX) {
+    io->parts_.push_back({io.get(), first, std::min<size_t>(io->pages_.size() - first, IOV_MAX)});
+  }
+
+  std::unique_lock<std::mutex> lock(ring_latch_);
+  io_ticket_t                  ticket = next_ticket_++;
+  // the completion queue must never overflow, fall back to synchronous I/O beyond its depth
+  if (ring_->IsAvailable() && in_flight_ + num_parts <= ring_->GetCompletionDepth()) {
+    for (auto &part : io->parts_) {
+      auto offset = static_cast<off_t>(io->page_id_ + static_cast<page_id_t>(part.first_)) * PAGE_SIZE;
+      while (!ring_->Prepare(io->write_, io->fid_, &io->iov_[part.first_], static_cast<unsigned>(part.count_), offset,
+          reinterpret_cast<uint64_t>(&part))) {
+        // submission queue is full
+        if (!ring_->Submit()) {
+          WSDB_FETAL(fmt::format("Submit to io_uring failed: {}", strerror(errno)));
+        }
+      }
+    }
+    if (!ring_->Submit()) {
+      WSDB_FETAL(fmt::format("Submit to io_uring failed: {}", strerror(errno)));
+    }
+    in_flight_ += num_parts;
+    io->pending_ = num_parts;
+    async_ios_.emplace(ticket, std::move(io));
+    return ticket;
+  }
+  lock.unlock();
+
+  // done synchronously on the pages themselves, ReadPages and WritePages bounce unaligned pages on their own
+  io->bounce_.reset();
+  try {
+    if (io->write_) {
+      WritePages(io->fid_, io->page_id_, {io->pages_.begin(), io->pages_.end()});
+    } else {
+      ReadPages(io->fid_, io->page_id_, io->pages_);
+    }
+  } catch (WSDBException_ &e) {
+    io->error_ = std::current_exception();
+  }
+  for (auto &part : io->parts_) {
+    part.result_ = static_cast<int>(part.count_ * PAGE_SIZE);
+  }
+  lock.lock();
+  async_ios_.emplace(ticket, std::move(io));
+  return ticket;
+}
+
+void DiskManager::ReapCompletions()
+{
+  uint64_t user_data;
+  int      result;
+  while (ring_->IsAvailable() && ring_->PopCompletion(&user_data, &result)) {
+    auto *part    = reinterpret_cast<AsyncIOPart *>(user_data);
+    part->result_ = result;
+    part->io_->pending_--;
+    in_flight_--;
+  }
+}
+
+auto DiskManager::PollIO(io_ticket_t ticket) -> bool
+{
+  std::lock_guard<std::mutex> lock(ring_latch_);
+  auto                        it = async_ios_.find(ticket);
+  WSDB_ASSERT(it != async_ios_.end(), fmt::format("io ticket: {}", ticket));
+  if (!reaping_) {
+    ReapCompletions();
+  }
+  return it->second->pending_ == 0;
+}
+
+void DiskManager::WaitIO(io_ticket_t ticket)
+{
+  std::unique_lock<std::mutex> lock(ring_latch_);
+  auto                         it = async_ios_.find(ticket);
+  WSDB_ASSERT(it != async_ios_.end(), fmt::format("io ticket: {}", ticket));
+  AsyncIO *io = it->second.get();
+  while (io->pending_ > 0) {
+    if (reaping_) {
+      ring_cv_.wait(lock);
+      continue;
+    }
+    ReapCompletions();
+    if (io->pending_ == 0) {
+      break;
+    }
+    reaping_ = true;
+    lock.unlock();
+    bool waited = ring_->Wait();
+    int  err    = errno;
+    lock.lock();
+    ReapCompletions();
+    reaping_ = false;
+    ring_cv_.notify_all();
+    if (!waited) {
+      // the kernel may still be transferring into the buffers of the operations in flight, they can not be handed
+      // back to the callers with an exception, same as a failed submission
+      WSDB_FETAL(fmt::format("Wait for io_uring completions failed: {}", strerror(err)));
+    }
+  }
+  auto owned = std::move(it->second);
+  async_ios_.erase(it);
+  lock.unlock();
+
+  if (owned->error_) {
+    std::rethrow_exception(owned->error_);
+  }
+  for (auto &part : owned->parts_) {
+    if (part.result_ == static_cast<int>(part.count_ * PAGE_SIZE)) {
+      if (owned->bounce_ != nullptr && !owned->write_) {
+        for (size_t i = part.first_; i < part.first_ + part.count_; i++) {
+          std::memcpy(owned->pages_[i], owned->iov_[i].iov_base, PAGE_SIZE);
+        }
+      }
+      continue;
+    }
+    page_id_t page_id = owned->page_id_ + static_cast<page_id_t>(part.first_);
+    if (part.result_ < 0 && part.result_ != -EINTR && part.result_ != -EAGAIN) {
+      WSDB_THROW(owned->write_ ? WSDB_FILE_WRITE_ERROR : WSDB_FILE_READ_ERROR,
+          fmt::format("fid: {}, page_id: {}, {}", owned->fid_, page_id, strerror(-part.result_)));
+    }
+    // short transfer, or the end of the file for a read, redo the part synchronously
+    auto first = owned->pages_.begin() + static_cast<ptrdiff_t>(part.first_);
+    auto last  = first + static_cast<ptrdiff_t>(part.count_);
+    if (owned->write_) {
+      WritePages(owned->fid_, page_id, {first, last});
+    } else {
+      ReadPages(owned->fid_, page_id, {first, last});
+    }
+  }
+}
+
+auto DiskManager::GetFilePageCount(file_id_t fid) -> size_t { return GetFileSize(fid) / PAGE_SIZE; }
+
+auto DiskManager::GetFileSize(file_id_t fid) -> size_t
+{
+  struct stat st
+  {};
+  if (fstat(fid, &st) < 0) {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("fid: {}", fid));
+  }
+  return static_cast<size_t>(st.st_size);
+}
+
+void DiskManager::AllocatePages(file_id_t fid, page_id_t page_id, size_t num_pages)
+{
+  WSDB_ASSERT(IsOpened(fid), fmt::format("fid: {}", fid));
+  auto offset = static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE);
+  auto len    = static_cast<off_t>(num_pages * PAGE_SIZE);
+  int  ret;
+  do {
+    ret = fallocate(fid, FALLOC_FL_KEEP_SIZE, offset, len);
+  } while (ret < 0 && errno == EINTR);
+  // ftruncate is no substitute, it could shrink the file under a concurrent write beyond the new size
+  if (ret < 0 && errno != EOPNOTSUPP && errno != ENOSYS) {
+    WSDB_THROW(WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, page_id: {}, {}", fid, page_id, strerror(errno)));
+  }
+}
+
+void DiskManager::ReadFile(file_id_t fid, char *data, size_t size, size_t offset, int type)
+{
+  auto entry = GetFileEntry(fid);
+  WSDB_ASSERT(entry != nullptr, "File not Opened");
+  WSDB_ASSERT(type == SEEK_CUR || type == SEEK_SET || type == SEEK_END, "Invalid Type");
+  std::lock_guard<std::mutex> lock(entry->cursor_latch_);
+  off_t                       pos = static_cast<off_t>(offset);
+  if (type == SEEK_CUR) {
+    pos += entry->cursor_;
+  } else if (type == SEEK_END) {
+    pos += static_cast<off_t>(GetFileSize(fid));
+  }
+  auto ret = entry->direct_ ? ReadBlocks(fid, data, size, pos) : ReadAt(fid, data, size, pos);
+  if (ret < size) {
+    std::memset(data + ret, 0, size - ret);
+  }
+  entry->cursor_ = pos + static_cast<off_t>(ret);
+}
+
+void DiskManager::WriteFile(file_id_t fid, const char *data, size_t size, int type)
+{
+  auto entry = GetFileEntry(fid);
+  WSDB_ASSERT(entry != nullptr, "File not Opened");
+  WSDB_ASSERT(type == SEEK_CUR || type == SEEK_SET || type == SEEK_END, "Invalid Type");
+  std::lock_guard<std::mutex> lock(entry->cursor_latch_);
+  off_t                       pos = 0;
+  if (type == SEEK_CUR) {
+    pos = entry->cursor_;
+  } else if (type == SEEK_END) {
+    pos = static_cast<off_t>(GetFileSize(fid));
+  }
+  if (!(entry->direct_ ? WriteBlocks(fid, data, size, pos) : WriteAt(fid, data, size, pos))) {
+    WSDB_THROW(WSDB_FILE_WRITE_ERROR, fmt::format("fid: {}, {}", fid, strerror(errno)));
+  }
+  entry->cursor_ = pos + static_cast<off_t>(size);
+}
+
+auto DiskManager::ReadBlocks(file_id_t fid, char *data, size_t size, off_t offset) -> size_t
+{
+  off_t  begin  = offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  size_t skip   = static_cast<size_t>(offset - begin);
+  size_t len    = (skip + size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  auto   blocks = AllocAligned(len);
+  size_t ret    = ReadAt(fid, blocks.get(), len, begin, true);
+  size_t n      = ret > skip ? std::min(ret - skip, size) : 0;
+  std::memcpy(data, blocks.get() + skip, n);
+  return n;
+}
+
+auto DiskManager::WriteBlocks(file_id_t fid, const char *data, size_t size, off_t offset) -> bool
+{
+  off_t  begin  = offset / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  size_t skip   = static_cast<size_t>(offset - begin);
+  size_t len    = (skip + size + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+  auto   blocks = AllocAligned(len);
+  size_t ret    = ReadAt(fid, blocks.get(), len, begin, true);
+  std::memset(blocks.get() + ret, 0, len - ret);
+  std::memcpy(blocks.get() + skip, data, size);
+  return WriteAt(fid, blocks.get(), len, begin);
+}
+
+void DiskManager::WriteLog(const std::string &log_file, const std::string &log_string)
+{
+  auto &log = GetLog(log_file);
+  log.WaitDurable(log.Append(log_string.data(), log_string.size()));
+}
+
+void DiskManager::ReadLog(const std::string &log_file, std::string &log_string)
+{
+  log_string.clear();
+  {
+    std::lock_guard<std::mutex> lock(log_latch_);
+    auto                        it = logs_.find(log_file);
+    if (it != logs_.end()) {
+      it->second->Flush();
+    }
+  }
+  int fd = open(log_file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return;
+    }
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("{}: {}", log_file, strerror(errno)));
+  }
+  struct stat st
+  {};
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    WSDB_THROW(WSDB_FILE_READ_ERROR, fmt::format("{}: {}", log_file, strerror(errno)));
+  }
+  log_string.resize(static_cast<size_t>(st.st_size));
+  try {
+    log_string.resize(ReadAt(fd, log_string.data(), log_string.size(), 0));
+  } catch (WSDBException_ &e) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+}
+
+auto DiskManager::GetLog(const std::string &log_file) -> GroupCommitLog &
+{
+  std::lock_guard<std::mutex> lock(log_latch_);
+  auto                       &log = logs_[log_file];
+  if (log == nullptr) {
+    log = std::make_unique<GroupCommitLog>(log_file);
+  }
+  return *log;
+}
+
+auto DiskManager::GetFileId(const std::string &fname) -> file_id_t
+{
+  std::lock_guard<std::mutex> lock(name_latch_);
+  auto                        it = name_fid_map_.find(fname);
+  if (it != name_fid_map_.end()) {
+    return it->second;
+  } else {
+    return INVALID_FILE_ID;
+  }
+}
+
+auto DiskManager::GetFileName(file_id_t fid) -> std::string
+{
+  auto entry = GetFileEntry(fid);
+  if (entry != nullptr) {
+    return entry->name_;
+  } else {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("fid: {}", fid));
+  }
+}
+
+auto DiskManager::FileExists(const std::string &fname) -> bool { return std::filesystem::exists(fname); }
+
+}  // namespace wsdb
@@ -1,97 +1,347 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#ifndef NJU_DBCOURSE_DISK_MANAGER_H
-#define NJU_DBCOURSE_DISK_MANAGER_H
-
-#include <iostream>
-#include <fstream>
-#include <future>
-#include <unordered_map>
-#include "common/types.h"
-
-namespace wsdb {
-class DiskManager
-{
-public:
-  DiskManager() = default;
-
-  ~DiskManager() = default;
-
-  /**
-   * Create a file named file_name and close it immediately
-   * @param fname
-   */
-  static void CreateFile(const std::string &fname);
-
-  /**
-   * Destroy file and should check that the file should not be opened,
-   * if opened, should close and then destroy (unlink)
-   * @param fname
-   */
-  static void DestroyFile(const std::string &fname);
-
-  /**
-   * Open the file named tab_name, add the opened file to the file map, and return the table id
-   * If table does not exist, return -1
-   * @param tab_name
-   */
-  auto OpenFile(const std::string &fname) -> file_id_t;
-
-  /**
-   * Close the file given table id, and remove related information from structures
-   * @param tab_name
-   */
-  void CloseFile(file_id_t fid);
-
-  void WritePage(file_id_t fid, page_id_t page_id, const char *data);
-
-  void ReadPage(file_id_t fid, page_id_t page_id, char *data);
-
-  void ReadFile(file_id_t fid, char *data, size_t size, size_t offset, int type);
-
-  /**
-   *
-   * @param fid
-   * @param data
-   * @param size
-   * @param pos ios::beg, ios::cur, ios::end
-   */
-  void WriteFile(file_id_t fid, const char *data, size_t size, int type);
-
-  void WriteLog(const std::string &log_file, const std::string &log_string);
-
-  void ReadLog(const std::string &log_file, std::string &log_string);
-
-  auto GetFileId(const std::string &fname) -> file_id_t;
-
-  auto GetFileName(file_id_t fid) -> std::string;
-
-  static auto FileExists(const std::string &fname) -> bool;
-
-private:
-  std::unordered_map<std::string, file_id_t> name_fid_map_;
-  std::unordered_map<file_id_t, std::string> fid_name_map_;
-};
-
-}  // namespace wsdb
-
-#endif  // NJU_DBCOURSE_DISK_MANAGER_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#ifndef NJU_DBCOURSE_DISK_MANAGER_H
+#define NJU_DBCOURSE_DISK_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <iostream>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
+#include "common/types.h"
+#include "group_commit_log.h"
+#include "io_ring.h"
+
+namespace wsdb {
+
+using io_ticket_t = uint64_t;
+
+// alignment of the buffers, offsets and sizes of direct I/O, a multiple of the logical block size of common devices
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+/**
+ * All page and file I/O is positional (pread/pwrite), so any number of threads can work on the same file at the same
+ * time. The page I/O path only checks the state of the fd in a lock-free table, the other information of an opened file
+ * is looked up under the mutex serializing opening and closing files.
+ * Runs of pages can also be read and written asynchronously through io_uring, see SubmitReadPages.
+ * In direct I/O mode page files bypass the kernel page cache (O_DIRECT), so that they are only cached by the buffer
+ * pool. Buffers that are not aligned to DIRECT_IO_ALIGNMENT go through an aligned bounce buffer.
+ */
+class DiskManager
+{
+public:
+  /**
+   * @param io_depth submission queue depth of io_uring, 0 disables it and asynchronous I/O becomes synchronous
+   * @param direct_io open page files with O_DIRECT
+   */
+  explicit DiskManager(size_t io_depth = IO_RING_DEPTH, bool direct_io = false);
+
+  ~DiskManager();
+
+  /**
+   * Create a file named file_name and close it immediately
+   * @param fname
+   */
+  static void CreateFile(const std::string &fname);
+
+  /**
+   * Destroy file and should check that the file should not be opened,
+   * if opened, should close and then destroy (unlink)
+   * @param fname
+   */
+  static void DestroyFile(const std::string &fname);
+
+  /**
+   * Open the file named tab_name, add the opened file to the file map, and return the table id
+   * If table does not exist, return -1
+   * @param tab_name
+   * @param page_file whether the file is accessed through the buffer pool (tables and indexes), page files are opened
+   * with O_DIRECT in direct I/O mode, unless the file system does not support it (e.g. tmpfs)
+   */
+  auto OpenFile(const std::string &fname, bool page_file = false) -> file_id_t;
+
+  /**
+   * Close the file given table id, and remove related information from structures
+   * @param tab_name
+   */
+  void CloseFile(file_id_t fid);
+
+  void WritePage(file_id_t fid, page_id_t page_id, const char *data);
+
+  /**
+   * Read a page, the part beyond the end of the file is zero-filled
+   * @param fid
+   * @param page_id
+   * @param data
+   */
+  void ReadPage(file_id_t fid, page_id_t page_id, char *data);
+
+  /**
+   * Read consecutive pages with vectored reads, the part beyond the end of the file is zero-filled
+   * @param fid
+   * @param page_id id of the first page
+   * @param pages buffers of PAGE_SIZE bytes, one for each page
+   */
+  void ReadPages(file_id_t fid, page_id_t page_id, const std::vector<char *> &pages);
+
+  /**
+   * Write consecutive pages with vectored writes, one system call for up to IOV_MAX pages
+   * @param fid
+   * @param page_id id of the first page
+   * @param pages buffers of PAGE_SIZE bytes, one for each page
+   */
+  void WritePages(file_id_t fid, page_id_t page_id, const std::vector<const char *> &pages);
+
+  /**
+   * Asynchronous version of ReadPages, the read runs in the background and is collected by WaitIO.
+   * Without io_uring, or when the ring is full, the read is done before returning and WaitIO only reports the result.
+   * The buffers must stay valid until WaitIO returns
+   * @return ticket of the read, must be passed to WaitIO exactly once
+   */
+  auto SubmitReadPages(file_id_t fid, page_id_t page_id, const std::vector<char *> &pages) -> io_ticket_t;
+
+  /**
+   * Asynchronous version of WritePages, see SubmitReadPages
+   */
+  auto SubmitWritePages(file_id_t fid, page_id_t page_id, const std::vector<const char *> &pages) -> io_ticket_t;
+
+  /**
+   * @return true if the operation has completed, WaitIO would not block
+   */
+  auto PollIO(io_ticket_t ticket) -> bool;
+
+  /**
+   * Wait for a submitted operation, throw WSDB_FILE_READ_ERROR or WSDB_FILE_WRITE_ERROR if it failed.
+   * Short transfers are completed synchronously, the part of a read beyond the end of the file is zero-filled
+   * @param ticket
+   */
+  void WaitIO(io_ticket_t ticket);
+
+  [[nodiscard]] auto UsesIOUring() const -> bool { return ring_->IsAvailable(); }
+
+  /**
+   * @return true if the file is opened with O_DIRECT
+   */
+  auto IsDirectIO(file_id_t fid) const -> bool;
+
+  /**
+   * @return number of pages of the file on disk, pages only in the buffer pool are not counted
+   */
+  auto GetFilePageCount(file_id_t fid) -> size_t;
+
+  auto GetFileSize(file_id_t fid) -> size_t;
+
+  /**
+   * Allocate disk space for pages [page_id, page_id + num_pages) with fallocate, appending pages one at a time then does
+   * not allocate blocks on every page. The file size is kept (FALLOC_FL_KEEP_SIZE), so GetFilePageCount and read-ahead
+   * still only see the pages written, the caller tracks how far it has allocated. Nothing is done if the file system
+   * does not support it, the pages are allocated when written
+   * @param fid
+   * @param page_id
+   * @param num_pages
+   */
+  void AllocatePages(file_id_t fid, page_id_t page_id, size_t num_pages);
+
+  /**
+   * Read from the stream cursor of the file, the cursor is kept by the disk manager instead of the fd so that page
+   * I/O of other threads does not move it. The part beyond the end of the file is zero-filled.
+   * On a file opened with O_DIRECT the stream functions read and write whole aligned blocks, a write pads the file to
+   * a block boundary, and must not overlap pages written at the same time
+   * @param fid
+   * @param data
+   * @param size
+   * @param offset offset relative to the position given by type
+   * @param type SEEK_SET, SEEK_CUR, SEEK_END
+   */
+  void ReadFile(file_id_t fid, char *data, size_t size, size_t offset, int type);
+
+  /**
+   *
+   * @param fid
+   * @param data
+   * @param size
+   * @param pos ios::beg, ios::cur, ios::end
+   */
+  void WriteFile(file_id_t fid, const char *data, size_t size, int type);
+
+  /**
+   * Append the string to the log file and wait until it is durable, concurrent writers of a log share its syncs
+   * @param log_file
+   * @param log_string
+   */
+  void WriteLog(const std::string &log_file, const std::string &log_string);
+
+  /**
+   * Read the whole log file, including the records still in the log buffer
+   * @param log_file
+   * @param log_string empty if the log does not exist
+   */
+  void ReadLog(const std::string &log_file, std::string &log_string);
+
+  /**
+   * Get the group commit log of the file, opened on first use and closed with the disk manager.
+   * A log manager appends records to it and only waits for them to be durable at commit, see GroupCommitLog
+   * @param log_file
+   * @return
+   */
+  auto GetLog(const std::string &log_file) -> GroupCommitLog &;
+
+  auto GetFileId(const std::string &fname) -> file_id_t;
+
+  auto GetFileName(file_id_t fid) -> std::string;
+
+  static auto FileExists(const std::string &fname) -> bool;
+
+private:
+  /**
+   * An opened file, shared with the stream I/O in progress on it so that it outlives CloseFile until they finish
+   */
+  struct FileEntry
+  {
+    FileEntry(std::string name, bool direct) : name_(std::move(name)), direct_(direct) {}
+
+    const std::string name_;
+    const bool        direct_;
+    std::mutex        cursor_latch_;  // protects cursor_
+    off_t             cursor_{0};     // stream cursor of ReadFile and WriteFile
+  };
+
+  // state of an fd in the lock-free table, FILE_DIRECT is only set together with FILE_OPENED
+  static constexpr uint8_t FILE_CLOSED = 0;
+  static constexpr uint8_t FILE_OPENED = 1;
+  static constexpr uint8_t FILE_DIRECT = 2;
+
+  // the table is two-level and indexed by the fd, chunks are allocated on demand and never freed, a slot is a single
+  // byte and is reused by the next file getting the same fd, so closed files leave nothing behind
+  static constexpr size_t FILE_CHUNK_SIZE = 1024;
+  static constexpr size_t FILE_CHUNK_NUM  = 1024;
+
+  using FileChunk = std::array<std::atomic<uint8_t>, FILE_CHUNK_SIZE>;
+
+  struct AsyncIO;
+
+  /**
+   * One submission of an asynchronous operation, an operation of more than IOV_MAX pages is split into several parts
+   */
+  struct AsyncIOPart
+  {
+    AsyncIO *io_;
+    size_t   first_;  // index of the first page in the operation
+    size_t   count_;
+    int      result_{0};  // bytes transferred or -errno
+  };
+
+  struct AlignedFree
+  {
+    void operator()(char *p) const { std::free(p); }
+  };
+
+  using AlignedBuffer = std::unique_ptr<char[], AlignedFree>;
+
+  static auto AllocAligned(size_t size) -> AlignedBuffer;
+
+  struct AsyncIO
+  {
+    bool                     write_;
+    file_id_t                fid_;
+    page_id_t                page_id_;
+    std::vector<char *>      pages_;
+    std::vector<iovec>       iov_;
+    std::vector<AsyncIOPart> parts_;
+    AlignedBuffer            bounce_;      // holds the pages of a direct I/O if they are not aligned
+    size_t                   pending_{0};  // parts in flight
+    std::exception_ptr       error_;       // error of a synchronous operation
+  };
+
+  auto SubmitIO(std::unique_ptr<AsyncIO> io) -> io_ticket_t;
+
+  /**
+   * Collect the available completions, should be called with ring_latch_ held
+   */
+  void ReapCompletions();
+
+  /**
+   * Lock-free lookup of the state of an fd
+   * @param fid
+   * @return FILE_CLOSED if the file is not opened
+   */
+  auto GetFileState(file_id_t fid) const -> uint8_t;
+
+  [[nodiscard]] auto IsOpened(file_id_t fid) const -> bool { return GetFileState(fid) != FILE_CLOSED; }
+
+  /**
+   * @return the entry of the opened file, nullptr if the file is not opened
+   */
+  auto GetFileEntry(file_id_t fid) -> std::shared_ptr<FileEntry>;
+
+  /**
+   * Read until size bytes are read or the end of the file is reached, retrying short reads
+   * @param direct a short read of a direct I/O is the end of the file, a retry from there would be unaligned
+   * @return number of bytes read, less than size only at the end of the file
+   */
+  static auto ReadAt(file_id_t fid, char *data, size_t size, off_t offset, bool direct = false) -> size_t;
+
+  /**
+   * Write all size bytes, retrying short writes
+   * @return false on error
+   */
+  static auto WriteAt(file_id_t fid, const char *data, size_t size, off_t offset) -> bool;
+
+  /**
+   * Stream I/O of a direct I/O file, read-modify-write of the aligned blocks covering [offset, offset + size)
+   */
+  static auto ReadBlocks(file_id_t fid, char *data, size_t size, off_t offset) -> size_t;
+
+  static auto WriteBlocks(file_id_t fid, const char *data, size_t size, off_t offset) -> bool;
+
+private:
+  bool                                                      direct_io_;
+  std::array<std::atomic<FileChunk *>, FILE_CHUNK_NUM>      file_chunks_{};
+  std::mutex                                                name_latch_;  // serializes OpenFile and CloseFile
+  std::unordered_map<std::string, file_id_t>                name_fid_map_;
+  std::unordered_map<file_id_t, std::shared_ptr<FileEntry>> files_;  // protected by name_latch_
+
+  // asynchronous I/O, only one thread at a time blocks in the kernel for completions (reaping_), the others wait on
+  // ring_cv_ for it to hand out what it reaped
+  IORingUptr                                                  ring_;
+  std::mutex                                                  ring_latch_;
+  std::condition_variable                                     ring_cv_;
+  bool                                                        reaping_{false};
+  size_t                                                      in_flight_{0};  // parts submitted to the ring
+  io_ticket_t                                                 next_ticket_{0};
+  std::unordered_map<io_ticket_t, std::unique_ptr<AsyncIO>> async_ios_;
+
+  std::mutex                                          log_latch_;  // protects logs_
+  std::unordered_map<std::string, GroupCommitLogUptr> logs_;
+};
+
+}  // namespace wsdb
+
+#endif  // NJU_DBCOURSE_DISK_MANAGER_H
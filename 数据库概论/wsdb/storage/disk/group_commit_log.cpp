@@ -0,0 +1,157 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "group_commit_log.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "../../../common/error.h"
+
+namespace wsdb {
+
+GroupCommitLog::GroupCommitLog(const std::string &fname, size_t buffer_size)
+    : fname_(fname), capacity_(buffer_size), buffer_(std::make_unique<char[]>(buffer_size))
+{
+  fd_ = open(fname.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("{}: {}", fname, strerror(errno)));
+  }
+  struct stat st
+  {};
+  if (fstat(fd_, &st) < 0) {
+    close(fd_);
+    WSDB_THROW(WSDB_FILE_NOT_OPEN, fmt::format("{}: {}", fname, strerror(errno)));
+  }
+  auto end = static_cast<uint64_t>(st.st_size);
+  reserved_.store(end);
+  published_.store(end);
+  durable_.store(end);
+  flusher_ = std::thread(&GroupCommitLog::FlusherLoop, this);
+}
+
+GroupCommitLog::~GroupCommitLog()
+{
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    stop_ = true;
+  }
+  flush_cv_.notify_one();
+  flusher_.join();
+  close(fd_);
+}
+
+auto GroupCommitLog::Append(const char *data, size_t size) -> uint64_t
+{
+  WSDB_ASSERT(size <= capacity_, fmt::format("log record of {} bytes exceeds the log buffer", size));
+  uint64_t lsn = reserved_.fetch_add(size, std::memory_order_relaxed);
+  if (lsn + size > durable_.load(std::memory_order_acquire) + capacity_) {
+    // the buffer is full, wait for the flusher to free the space
+    std::unique_lock<std::mutex> lock(latch_);
+    flush_requested_ = true;
+    flush_cv_.notify_one();
+    durable_cv_.wait(lock, [&] { return lsn + size <= durable_.load() + capacity_; });
+  }
+  size_t pos   = lsn % capacity_;
+  size_t first = std::min(size, capacity_ - pos);
+  std::memcpy(buffer_.get() + pos, data, first);
+  std::memcpy(buffer_.get(), data + first, size - first);
+  // publish in log order, the records before are being copied by other appenders and take no longer than this one
+  while (published_.load(std::memory_order_acquire) != lsn) {
+    std::this_thread::yield();
+  }
+  published_.store(lsn + size, std::memory_order_release);
+  records_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(size, std::memory_order_relaxed);
+  return lsn + size;
+}
+
+void GroupCommitLog::WaitDurable(uint64_t lsn)
+{
+  waits_.fetch_add(1, std::memory_order_relaxed);
+  if (durable_.load(std::memory_order_acquire) >= lsn) {
+    return;
+  }
+  auto                         start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(latch_);
+  if (!flush_requested_) {
+    flush_requested_ = true;
+    flush_cv_.notify_one();
+  }
+  durable_cv_.wait(lock, [&] { return durable_.load() >= lsn; });
+  auto ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+  wait_ns_ += ns;
+  max_wait_ns_ = std::max(max_wait_ns_, ns);
+}
+
+void GroupCommitLog::Flush() { WaitDurable(published_.load(std::memory_order_acquire)); }
+
+auto GroupCommitLog::GetStats() -> GroupCommitStats
+{
+  std::lock_guard<std::mutex> lock(latch_);
+  return {records_.load(), bytes_.load(), syncs_, waits_.load(), wait_ns_, max_wait_ns_};
+}
+
+void GroupCommitLog::FlusherLoop()
+{
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    flush_cv_.wait_for(lock, GROUP_COMMIT_INTERVAL, [this] { return stop_ || flush_requested_; });
+    // the records appended while the last group was synced form the next group
+    flush_requested_ = false;
+    uint64_t from    = durable_.load(std::memory_order_relaxed);
+    uint64_t to      = published_.load(std::memory_order_acquire);
+    if (from == to) {
+      if (stop_) {
+        break;
+      }
+      continue;
+    }
+    lock.unlock();
+    if (!WriteRange(from, to) || fdatasync(fd_) != 0) {
+      // commits can neither be made durable nor be given up, there is no way to go on
+      WSDB_FETAL(fmt::format("Write log {} failed: {}", fname_, strerror(errno)));
+    }
+    lock.lock();
+    durable_.store(to, std::memory_order_release);
+    syncs_++;
+    durable_cv_.notify_all();
+  }
+}
+
+auto GroupCommitLog::WriteRange(uint64_t from, uint64_t to) -> bool
+{
+  while (from < to) {
+    size_t  pos = from % capacity_;
+    size_t  len = std::min<uint64_t>(to - from, capacity_ - pos);
+    ssize_t ret = pwrite(fd_, buffer_.get() + pos, len, static_cast<off_t>(from));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    from += static_cast<uint64_t>(ret);
+  }
+  return true;
+}
+
+}  // namespace wsdb
@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_GROUP_COMMIT_LOG_H
+#define WSDB_GROUP_COMMIT_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include "../../../common/micro.h"
+
+namespace wsdb {
+
+// size of the in-memory log buffer, a record must not be larger
+static constexpr size_t GROUP_COMMIT_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// the flusher also writes the log this often without being asked, so that the buffer does not fill up
+static constexpr std::chrono::milliseconds GROUP_COMMIT_INTERVAL{10};
+
+struct GroupCommitStats
+{
+  size_t records_{0};  // records appended
+  size_t bytes_{0};    // bytes appended
+  size_t syncs_{0};    // fdatasync calls, records_ / syncs_ is the size of a commit group
+
+  size_t   waits_{0};        // WaitDurable and Flush calls, including those finding the log already durable
+  uint64_t wait_ns_{0};      // time spent in them, wait_ns_ / waits_ is the average commit latency
+  uint64_t max_wait_ns_{0};  // the longest of them
+};
+
+/**
+ * An append-only log file written through a ring buffer by a dedicated flusher thread, with group commit:
+ * all the records appended while the flusher is writing and syncing are made durable by its next fdatasync,
+ * so N concurrent commits cost far fewer than N syncs.
+ * A position in the log is its byte offset in the file (log sequence number).
+ * 1. Append reserves space in the buffer with one atomic add, copies the record, then publishes it in log order,
+ * appenders never take a lock unless the buffer is full
+ * 2. WaitDurable wakes up the flusher and waits until the log is durable up to a position
+ * 3. the flusher writes the published part of the buffer, syncs it and wakes up the waiters
+ */
+class GroupCommitLog
+{
+public:
+  /**
+   * Open the log file, create it if it does not exist, new records are appended to its end
+   * @param fname
+   * @param buffer_size
+   */
+  explicit GroupCommitLog(const std::string &fname, size_t buffer_size = GROUP_COMMIT_BUFFER_SIZE);
+
+  /**
+   * Make all appended records durable and stop the flusher, no Append may be running
+   */
+  ~GroupCommitLog();
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(GroupCommitLog)
+
+  /**
+   * Append a record to the log, it is not durable until WaitDurable returns for the returned position
+   * @param data
+   * @param size
+   * @return end position of the record in the log
+   */
+  auto Append(const char *data, size_t size) -> uint64_t;
+
+  /**
+   * Wait until the log is durable up to the position. A failure to write the log is fatal, a commit can neither be
+   * made durable nor be given up once other transactions may depend on it
+   * @param lsn
+   */
+  void WaitDurable(uint64_t lsn);
+
+  /**
+   * Wait until all records appended so far are durable
+   */
+  void Flush();
+
+  [[nodiscard]] auto GetDurableLSN() const -> uint64_t { return durable_.load(std::memory_order_acquire); }
+
+  auto GetStats() -> GroupCommitStats;
+
+  [[nodiscard]] auto GetFileName() const -> const std::string & { return fname_; }
+
+private:
+  void FlusherLoop();
+
+  /**
+   * Write the published records [from, to) from the buffer to the file
+   * @return false on error
+   */
+  auto WriteRange(uint64_t from, uint64_t to) -> bool;
+
+private:
+  std::string             fname_;
+  int                     fd_;
+  size_t                  capacity_;
+  std::unique_ptr<char[]> buffer_;
+
+  std::atomic<uint64_t> reserved_;   // end of the space handed out to appenders
+  std::atomic<uint64_t> published_;  // the records before it are completely copied into the buffer
+  std::atomic<uint64_t> durable_;    // the records before it are synced to disk, buffer space before it is free
+
+  std::mutex              latch_;       // protects the flags below, and is the mutex of the condition variables
+  std::condition_variable flush_cv_;    // wakes up the flusher
+  std::condition_variable durable_cv_;  // wakes up the threads waiting for durable_
+  bool                    flush_requested_{false};
+  bool                    stop_{false};
+
+  std::atomic<size_t> records_{0};
+  std::atomic<size_t> bytes_{0};
+  std::atomic<size_t> waits_{0};
+  size_t              syncs_{0};
+  uint64_t            wait_ns_{0};  // only the waits that blocked add to it, under the latch
+  uint64_t            max_wait_ns_{0};
+
+  std::thread flusher_;
+};
+
+DEFINE_UNIQUE_PTR(GroupCommitLog);
+
+}  // namespace wsdb
+
+#endif  // WSDB_GROUP_COMMIT_LOG_H
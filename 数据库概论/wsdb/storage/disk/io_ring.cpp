@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#include "io_ring.h"
+
+#ifdef WSDB_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace wsdb {
+
+#ifdef WSDB_IO_URING
+
+// the head and tail indexes are shared with the kernel, the side consuming a ring reads the producer index with
+// acquire and publishes its own index with release
+static auto LoadAcquire(unsigned *p) -> unsigned { return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire); }
+
+static void StoreRelease(unsigned *p, unsigned v) { std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release); }
+
+IORing::IORing(unsigned entries)
+{
+  if (entries == 0) {
+    return;
+  }
+  io_uring_params params{};
+  int             fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    // ENOSYS on kernels without io_uring, EPERM if it is disabled by the administrator
+    return;
+  }
+  sq_entries_   = params.sq_entries;
+  cq_entries_   = params.cq_entries;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single   = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  cq_ring_ = single ? sq_ring_
+                    : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                          IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_      = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    Unmap();
+    close(fd);
+    return;
+  }
+  auto *sq  = static_cast<char *>(sq_ring_);
+  auto *cq  = static_cast<char *>(cq_ring_);
+  sq_head_  = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_  = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_  = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  cq_head_  = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_  = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_  = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_     = cq + params.cq_off.cqes;
+  ring_fd_  = fd;
+}
+
+IORing::~IORing()
+{
+  if (ring_fd_ < 0) {
+    return;
+  }
+  Unmap();
+  close(ring_fd_);
+}
+
+void IORing::Unmap()
+{
+  if (sqes_ != nullptr && sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  sq_ring_ = cq_ring_ = sqes_ = nullptr;
+}
+
+auto IORing::Prepare(bool write, int fd, const iovec *iov, unsigned iov_cnt, off_t offset, uint64_t user_data) -> bool
+{
+  unsigned tail = *sq_tail_;
+  if (tail - LoadAcquire(sq_head_) >= sq_entries_) {
+    return false;
+  }
+  unsigned idx = tail & *sq_mask_;
+  auto    *sqe = static_cast<io_uring_sqe *>(sqes_) + idx;
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->opcode    = write ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->fd        = fd;
+  sqe->addr      = reinterpret_cast<uint64_t>(iov);
+  sqe->len       = iov_cnt;
+  sqe->off       = static_cast<uint64_t>(offset);
+  sqe->user_data = user_data;
+  sq_array_[idx] = idx;
+  StoreRelease(sq_tail_, tail + 1);
+  to_submit_++;
+  return true;
+}
+
+auto IORing::Submit() -> bool
+{
+  while (to_submit_ > 0) {
+    long ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit_, 0, 0, nullptr, 0);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret < 0) {
+      return false;
+    }
+    to_submit_ -= static_cast<unsigned>(ret);
+  }
+  return true;
+}
+
+auto IORing::Wait() -> bool
+{
+  while (LoadAcquire(cq_tail_) == LoadAcquire(cq_head_)) {
+    long ret = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (ret < 0 && errno != EINTR && errno != EAGAIN) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto IORing::PopCompletion(uint64_t *user_data, int *result) -> bool
+{
+  unsigned head = *cq_head_;
+  if (head == LoadAcquire(cq_tail_)) {
+    return false;
+  }
+  auto *cqe  = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+  *user_data = cqe->user_data;
+  *result    = cqe->res;
+  StoreRelease(cq_head_, head + 1);
+  return true;
+}
+
+#else
+
+IORing::IORing(unsigned entries) {}
+
+IORing::~IORing() = default;
+
+void IORing::Unmap() {}
+
+auto IORing::Prepare(bool write, int fd, const iovec *iov, unsigned iov_cnt, off_t offset, uint64_t user_data) -> bool
+{
+  return false;
+}
+
+auto IORing::Submit() -> bool { return false; }
+
+auto IORing::Wait() -> bool { return false; }
+
+auto IORing::PopCompletion(uint64_t *user_data, int *result) -> bool { return false; }
+
+#endif
+
+}  // namespace wsdb
@@ -0,0 +1,118 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+#ifndef WSDB_IO_RING_H
+#define WSDB_IO_RING_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include "../../../common/micro.h"
+
+namespace wsdb {
+
+// default number of submission queue entries, WSDB_IO_DEPTH overrides it, 0 disables io_uring
+static constexpr size_t IO_RING_DEPTH = 256;
+
+/**
+ * A minimal io_uring instance talking to the kernel with the raw system calls, so there is no dependency on liburing.
+ * The ring is only available when built with WSDB_IO_URING and the kernel supports io_uring (Linux 5.1 on), check
+ * IsAvailable before use. The class does no locking, submitting and reaping must be serialized by the owner, only Wait
+ * can be called concurrently with them.
+ */
+class IORing
+{
+public:
+  explicit IORing(unsigned entries);
+
+  ~IORing();
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(IORing)
+
+  [[nodiscard]] auto IsAvailable() const -> bool { return ring_fd_ >= 0; }
+
+  /**
+   * @return number of completion queue entries, the number of operations in flight must not exceed it
+   */
+  [[nodiscard]] auto GetCompletionDepth() const -> size_t { return cq_entries_; }
+
+  /**
+   * Queue a vectored read or write, it is not passed to the kernel until Submit
+   * @param write
+   * @param fd
+   * @param iov the buffers, must stay valid until the operation completes
+   * @param iov_cnt
+   * @param offset
+   * @param user_data returned with the completion
+   * @return false if the submission queue is full
+   */
+  auto Prepare(bool write, int fd, const iovec *iov, unsigned iov_cnt, off_t offset, uint64_t user_data) -> bool;
+
+  /**
+   * Pass the queued operations to the kernel
+   * @return false on error, errno is set
+   */
+  auto Submit() -> bool;
+
+  /**
+   * Block until at least one completion is available, interrupted waits are retried
+   * @return false on error, errno is set
+   */
+  auto Wait() -> bool;
+
+  /**
+   * Pop a completion without blocking
+   * @param user_data
+   * @param result bytes transferred, or -errno
+   * @return false if there is no completion
+   */
+  auto PopCompletion(uint64_t *user_data, int *result) -> bool;
+
+private:
+  void Unmap();
+
+private:
+  int      ring_fd_{-1};
+  unsigned sq_entries_{0};
+  unsigned cq_entries_{0};
+  unsigned to_submit_{0};  // prepared but not submitted
+
+  void  *sq_ring_{nullptr};
+  void  *cq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  void  *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // pointers into the rings shared with the kernel
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void     *cqes_{nullptr};
+};
+
+DEFINE_UNIQUE_PTR(IORing);
+
+}  // namespace wsdb
+
+#endif  // WSDB_IO_RING_H
@@ -0,0 +1,75 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#include "record_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace wsdb {
+
+RecordArena::RecordArena(size_t block_size) : block_size_(block_size) {}
+
+auto RecordArena::Allocate(size_t size, size_t align) -> char *
+{
+  size_t pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+  if (cur_ == nullptr || pad + size > left_) {
+    NewBlock(std::max(block_size_, size + align));
+    pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+  }
+  char *mem = cur_ + pad;
+  cur_ += pad + size;
+  left_ -= pad + size;
+  return mem;
+}
+
+auto RecordArena::Copy(const RecordView &record) -> RecordView
+{
+  auto   schema       = record.GetSchema();
+  size_t nullmap_size = BITMAP_SIZE(schema->GetFieldCount());
+  // the null map is put after the data, the data keeps the alignment of the allocation
+  char *mem = Allocate(schema->GetRecordLength() + nullmap_size);
+  std::memcpy(mem, record.GetData(), schema->GetRecordLength());
+  std::memcpy(mem + schema->GetRecordLength(), record.GetNullMap(), nullmap_size);
+  return {schema, mem + schema->GetRecordLength(), mem, record.GetRID()};
+}
+
+void RecordArena::Reset()
+{
+  if (blocks_.empty()) {
+    return;
+  }
+  blocks_.resize(1);
+  cur_      = blocks_[0].get();
+  left_     = first_block_size_;
+  reserved_ = first_block_size_;
+}
+
+void RecordArena::NewBlock(size_t size)
+{
+  blocks_.push_back(std::make_unique_for_overwrite<char[]>(size));
+  if (blocks_.size() == 1) {
+    first_block_size_ = size;
+  }
+  cur_  = blocks_.back().get();
+  left_ = size;
+  reserved_ += size;
+}
+
+}  // namespace wsdb
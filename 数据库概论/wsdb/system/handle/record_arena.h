@@ -0,0 +1,82 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#ifndef WSDB_RECORD_ARENA_H
+#define WSDB_RECORD_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "record_handle.h"
+
+namespace wsdb {
+
+// size of a memory block of a record arena, a larger request gets a block of its own
+static constexpr size_t RECORD_ARENA_BLOCK_SIZE = 256 * 1024;
+
+/**
+ * Bump allocator for the rows an operator keeps for the rest of the query, e.g. the sort buffer. Memory is taken from
+ * large blocks and only released all at once by Reset or the destructor, so keeping a row costs no malloc on average.
+ * Not thread-safe, an arena belongs to one operator
+ */
+class RecordArena
+{
+public:
+  explicit RecordArena(size_t block_size = RECORD_ARENA_BLOCK_SIZE);
+
+  ~RecordArena() = default;
+
+  DISABLE_COPY_MOVE_AND_ASSIGN(RecordArena)
+
+  /**
+   * Allocate size bytes aligned to align, the memory is valid until Reset
+   */
+  auto Allocate(size_t size, size_t align = alignof(std::max_align_t)) -> char *;
+
+  /**
+   * Copy the null map and data of a record into the arena
+   * @param record
+   * @return a view of the copy, valid until Reset
+   */
+  auto Copy(const RecordView &record) -> RecordView;
+
+  /**
+   * Release all the memory at once, the first block is kept for reuse
+   */
+  void Reset();
+
+  /**
+   * @return bytes of the blocks held by the arena
+   */
+  [[nodiscard]] auto GetReservedBytes() const -> size_t { return reserved_; }
+
+private:
+  void NewBlock(size_t size);
+
+  size_t                               block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  size_t                               first_block_size_{0};
+  char                                *cur_{nullptr};  // free memory of the last block
+  size_t                               left_{0};
+  size_t                               reserved_{0};
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_RECORD_ARENA_H
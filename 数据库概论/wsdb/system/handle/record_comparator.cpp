@@ -0,0 +1,157 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#include "record_comparator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace wsdb {
+
+template <typename T>
+static auto LoadField(const char *data) -> T
+{
+  // records in a page or an arena are not necessarily aligned
+  T val;
+  std::memcpy(&val, data, sizeof(T));
+  return val;
+}
+
+template <typename T>
+static auto CompareScalar(T lval, T rval) -> int
+{
+  // same order as the value operators, NaN equals anything
+  if (lval < rval) {
+    return -1;
+  }
+  if (lval > rval) {
+    return 1;
+  }
+  return 0;
+}
+
+static auto CompareString(const char *ldata, size_t lsize, const char *rdata, size_t rsize) -> int
+{
+  // strings are zero padded to the field size, padding sorts before any character like the end of a shorter string
+  size_t len = std::min(lsize, rsize);
+  if (int cmp = std::memcmp(ldata, rdata, len); cmp != 0) {
+    return cmp < 0 ? -1 : 1;
+  }
+  // the longer field is larger only if it goes on with a character
+  if (lsize > len && std::any_of(ldata + len, ldata + lsize, [](char c) { return c != '\0'; })) {
+    return 1;
+  }
+  if (rsize > len && std::any_of(rdata + len, rdata + rsize, [](char c) { return c != '\0'; })) {
+    return -1;
+  }
+  return 0;
+}
+
+RecordComparator::RecordComparator(const RecordSchema *schema)
+{
+  keys_.reserve(schema->GetFieldCount());
+  for (size_t i = 0; i < schema->GetFieldCount(); ++i) {
+    keys_.push_back(MakeKeyField(schema, i, schema, i));
+  }
+}
+
+RecordComparator::RecordComparator(const RecordSchema *lkey_schema, const RecordSchema *lschema,
+    const RecordSchema *rkey_schema, const RecordSchema *rschema)
+{
+  WSDB_ASSERT(lkey_schema->GetFieldCount() == rkey_schema->GetFieldCount(), "key field count mismatch");
+  keys_.reserve(lkey_schema->GetFieldCount());
+  for (size_t i = 0; i < lkey_schema->GetFieldCount(); ++i) {
+    auto lidx = lschema->GetRTFieldIndex(lkey_schema->GetFieldAt(i));
+    auto ridx = rschema->GetRTFieldIndex(rkey_schema->GetFieldAt(i));
+    if (lidx == lschema->GetFieldCount() || ridx == rschema->GetFieldCount()) {
+      WSDB_FETAL("Key field not found in record schema");
+    }
+    keys_.push_back(MakeKeyField(lschema, lidx, rschema, ridx));
+  }
+}
+
+auto RecordComparator::Compare(const RecordView &lhs, const RecordView &rhs) const -> int
+{
+  for (const auto &key : keys_) {
+    if (int cmp = CompareKeyField(key, lhs, rhs); cmp != 0) {
+      return cmp;
+    }
+  }
+  return 0;
+}
+
+auto RecordComparator::CompareField(const RecordView &lhs, size_t lidx, const RecordView &rhs, size_t ridx) -> int
+{
+  return CompareKeyField(MakeKeyField(lhs.GetSchema(), lidx, rhs.GetSchema(), ridx), lhs, rhs);
+}
+
+auto RecordComparator::MakeKeyField(const RecordSchema *lschema, size_t lidx, const RecordSchema *rschema, size_t ridx)
+    -> KeyField
+{
+  const auto &lfield = lschema->GetFieldAt(lidx).field_;
+  const auto &rfield = rschema->GetFieldAt(ridx).field_;
+  KeyField    key{KEY_VALUE,
+      lidx,
+      ridx,
+      lschema->GetFieldOffset(lidx),
+      rschema->GetFieldOffset(ridx),
+      lfield.field_size_,
+      rfield.field_size_};
+  if (lfield.field_type_ != rfield.field_type_) {
+    return key;
+  }
+  switch (lfield.field_type_) {
+    case FieldType::TYPE_BOOL: key.type_ = KEY_BOOL; break;
+    case FieldType::TYPE_INT: key.type_ = KEY_INT; break;
+    case FieldType::TYPE_FLOAT: key.type_ = KEY_FLOAT; break;
+    case FieldType::TYPE_STRING: key.type_ = KEY_STRING; break;
+    default: break;
+  }
+  return key;
+}
+
+auto RecordComparator::CompareKeyField(const KeyField &key, const RecordView &lhs, const RecordView &rhs) -> int
+{
+  bool lnull = lhs.IsNull(key.lidx_);
+  bool rnull = rhs.IsNull(key.ridx_);
+  if (lnull || rnull) {
+    return lnull == rnull ? 0 : (lnull ? -1 : 1);
+  }
+  const char *ldata = lhs.GetData() + key.loffset_;
+  const char *rdata = rhs.GetData() + key.roffset_;
+  switch (key.type_) {
+    case KEY_BOOL: return CompareScalar(LoadField<bool>(ldata), LoadField<bool>(rdata));
+    case KEY_INT: return CompareScalar(LoadField<int32_t>(ldata), LoadField<int32_t>(rdata));
+    case KEY_FLOAT: return CompareScalar(LoadField<float>(ldata), LoadField<float>(rdata));
+    case KEY_STRING: return CompareString(ldata, key.lsize_, rdata, key.rsize_);
+    case KEY_VALUE: {
+      auto lval = lhs.GetValueAt(key.lidx_);
+      auto rval = rhs.GetValueAt(key.ridx_);
+      if (*lval < *rval) {
+        return -1;
+      }
+      if (*lval > *rval) {
+        return 1;
+      }
+      return 0;
+    }
+  }
+  return 0;
+}
+
+}  // namespace wsdb
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#ifndef WSDB_RECORD_COMPARATOR_H
+#define WSDB_RECORD_COMPARATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "record_handle.h"
+
+namespace wsdb {
+
+/**
+ * Compares records on a list of key fields straight from their data, without creating values or key records.
+ * The key fields are resolved against the record schemas once at construction, so Compare does no lookup and no
+ * allocation. int, float, bool and fixed-length strings (zero padded, compared by memcmp) are compared from the raw
+ * bytes, a pair of fields of different types falls back to comparing values.
+ * A null is smaller than any value and equal to another null, as in Record::Compare
+ */
+class RecordComparator
+{
+public:
+  RecordComparator() = delete;
+
+  /**
+   * Compare records of schema on all of its fields
+   * @param schema
+   */
+  explicit RecordComparator(const RecordSchema *schema);
+
+  /**
+   * Compare records of lschema with records of rschema, the i-th field of lkey_schema is compared with the i-th field of
+   * rkey_schema, both looked up in the record schemas as Record(key_schema, record) does
+   * @param lkey_schema
+   * @param lschema
+   * @param rkey_schema
+   * @param rschema
+   */
+  RecordComparator(const RecordSchema *lkey_schema, const RecordSchema *lschema, const RecordSchema *rkey_schema,
+      const RecordSchema *rschema);
+
+  /**
+   * @return negative if lhs < rhs, 0 if equal, positive if lhs > rhs
+   */
+  [[nodiscard]] auto Compare(const RecordView &lhs, const RecordView &rhs) const -> int;
+
+  /**
+   * Compare field lidx of lhs with field ridx of rhs without resolving a key list first, for one-off comparisons
+   */
+  static auto CompareField(const RecordView &lhs, size_t lidx, const RecordView &rhs, size_t ridx) -> int;
+
+private:
+  enum KeyType : uint8_t
+  {
+    KEY_BOOL = 0,
+    KEY_INT,
+    KEY_FLOAT,
+    KEY_STRING,
+    KEY_VALUE,  // types differ or are not handled here, compare values
+  };
+
+  struct KeyField
+  {
+    KeyType type_;
+    size_t  lidx_;
+    size_t  ridx_;
+    size_t  loffset_;
+    size_t  roffset_;
+    size_t  lsize_;
+    size_t  rsize_;
+  };
+
+  static auto MakeKeyField(const RecordSchema *lschema, size_t lidx, const RecordSchema *rschema, size_t ridx)
+      -> KeyField;
+
+  static auto CompareKeyField(const KeyField &key, const RecordView &lhs, const RecordView &rhs) -> int;
+
+private:
+  std::vector<KeyField> keys_;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_RECORD_COMPARATOR_H
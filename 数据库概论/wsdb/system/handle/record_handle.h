@@ -1,220 +1,359 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/17.
-//
-
-#ifndef WSDB_RECORD_MANAGER_H
-#define WSDB_RECORD_MANAGER_H
-
-#include "../../../common/micro.h"
-#include "common/meta.h"
-#include "common/rid.h"
-#include "common/value.h"
-#include "common/bitmap.h"
-
-namespace wsdb {
-
-class Record;
-class Chunk;
-class RecordSchema;
-DEFINE_UNIQUE_PTR(Record);
-DEFINE_UNIQUE_PTR(RecordSchema);
-DEFINE_SHARED_PTR(RecordSchema);
-DEFINE_UNIQUE_PTR(Chunk);
-
-class RecordSchema
-{
-  friend Record;
-
-public:
-  RecordSchema() = delete;
-
-  explicit RecordSchema(std::vector<RTField> fields);
-
-  ~RecordSchema() = default;
-
-  // important: should not copy or move
-  DISABLE_COPY_MOVE_AND_ASSIGN(RecordSchema)
-
-  auto GetFields() const -> const std::vector<RTField> &;
-
-  void SetTableId(table_id_t tid);
-
-  [[nodiscard]] auto GetFieldAt(size_t index) const -> const RTField &;
-
-  [[nodiscard]] auto GetFieldOffset(size_t index) const -> size_t;
-
-  [[nodiscard]] auto GetFieldByName(table_id_t tid, const std::string &name) const -> const RTField &;
-
-  [[nodiscard]] auto GetFieldIndex(table_id_t tid, const std::string &name) const -> size_t;
-
-  /**
-   * get field index according to runtime information
-   * @return
-   */
-  [[nodiscard]] auto GetRTFieldIndex(const RTField &rtfield) const -> size_t;
-
-  [[nodiscard]] auto GetFieldOffset(table_id_t tid, const std::string &name) const -> size_t;
-
-  [[nodiscard]] auto GetRecordLength() const -> size_t;
-
-  [[nodiscard]] auto GetFieldCount() const -> size_t;
-
-  auto HasField(table_id_t tid, const std::string &name) -> bool;
-
-  [[nodiscard]] auto ToString() const -> std::string
-  {
-    std::string str;
-    for (const auto &rtfield : fields_) {
-      str += rtfield.ToString() + ", ";
-    }
-    if (!str.empty()) {
-      str.pop_back();
-      str.pop_back();
-    }
-    return str;
-  }
-
-private:
-  size_t               rec_len_;
-  std::vector<RTField> fields_;
-  std::vector<size_t>  offsets_;
-};
-
-/**
- * To prevent unexpected changes to a record, Record class is non-volatile (except rid),
- * if a record-like object is volatile, use RecordSchema + std::vector<ValueSptr> instead
- */
-class Record
-{
-public:
-  Record() = delete;
-
-  /**
-   * Generate a record from raw data
-   * @param schema
-   * @param null_map_mem
-   * @param data
-   * @param rid
-   */
-  Record(const RecordSchema *schema, const char *null_map_mem, const char *data, RID rid);
-
-  /**
-   * Generate a record from a list of values
-   * @param schema
-   * @param values
-   * @param rid
-   */
-  Record(const RecordSchema *schema, const std::vector<ValueSptr> &values, RID rid);
-
-  /**
-   * Generate a record from another record given the requested schema
-   * @param schema should be a subset of the original schema
-   * @param other the original record
-   */
-  Record(const RecordSchema *schema, const Record &other);
-
-  /**
-   * Generate a record from two records given the requested schema
-   * @param schema should be a combination of the two records' schema
-   * @param rec1 the first record
-   * @param rec2 the second record
-   */
-  Record(const RecordSchema *schema, const Record &rec1, const Record &rec2);
-
-  /**
-   * Generate a record with all fields set to null
-   * @param schema
-   */
-  explicit Record(const RecordSchema *schema);
-
-  ~Record();
-
-  Record(const Record &record);
-
-  Record &operator=(const Record &record);
-
-  Record(Record &&record) noexcept;
-
-  Record &operator=(Record &&record) noexcept;
-
-  auto operator==(const Record &other) const -> bool;
-
-  [[nodiscard]] auto Hash() const -> size_t;
-
-  void SetRID(const RID &rid) { rid_ = rid; }
-
-  /// Get the RID of this record
-  [[nodiscard]] auto GetRID() const -> RID { return rid_; }
-
-  [[nodiscard]] auto GetValueAt(size_t index) const -> ValueSptr;
-
-  /// Get the schema of this record
-  [[nodiscard]] auto GetSchema() const -> const RecordSchema * { return schema_; }
-
-  [[nodiscard]] auto GetData() const -> const char * { return data_; }
-
-  [[nodiscard]] auto GetNullMap() const -> const char * { return nullmap_; }
-
-  static auto Compare(const Record &lrec, const Record &rrec) -> int;
-
-private:
-  const RecordSchema *schema_;
-  char               *data_;
-  char               *nullmap_;
-  RID                 rid_{};
-};
-
-class Chunk
-{
-public:
-  Chunk() = delete;
-
-  Chunk(const RecordSchema *schema, std::vector<ArrayValueSptr> cols);
-
-  ~Chunk();
-
-  Chunk(const Chunk &chunk);
-
-  Chunk &operator=(const Chunk &chunk);
-
-  Chunk(Chunk &&chunk) noexcept;
-
-  Chunk &operator=(Chunk &&chunk) noexcept;
-
-  auto GetCol(int index) -> ArrayValueSptr;
-
-  auto GetColCount() -> size_t;
-
-private:
-  const RecordSchema         *schema_;
-  std::vector<ArrayValueSptr> cols_;
-};
-
-}  // namespace wsdb
-
-namespace std {
-template <>
-struct hash<wsdb::Record>
-{
-  auto operator()(const wsdb::Record &record) const -> size_t { return record.Hash(); }
-};
-}  // namespace std
-
-#endif  // WSDB_RECORD_MANAGER_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/17.
+//
+
+#ifndef WSDB_RECORD_MANAGER_H
+#define WSDB_RECORD_MANAGER_H
+
+#include "../../../common/micro.h"
+#include "../../../common/error.h"
+#include "common/meta.h"
+#include "common/rid.h"
+#include "common/value.h"
+#include "common/bitmap.h"
+
+namespace wsdb {
+
+class Record;
+class RecordView;
+class Chunk;
+class RecordSchema;
+DEFINE_UNIQUE_PTR(Record);
+DEFINE_UNIQUE_PTR(RecordSchema);
+DEFINE_SHARED_PTR(RecordSchema);
+DEFINE_UNIQUE_PTR(Chunk);
+
+// positions of the valid rows of a chunk in ascending order, e.g. the occupied slots of a page
+using SelectionVector = std::vector<uint32_t>;
+
+class RecordSchema
+{
+  friend Record;
+
+public:
+  RecordSchema() = delete;
+
+  explicit RecordSchema(std::vector<RTField> fields);
+
+  ~RecordSchema() = default;
+
+  // important: should not copy or move
+  DISABLE_COPY_MOVE_AND_ASSIGN(RecordSchema)
+
+  auto GetFields() const -> const std::vector<RTField> &;
+
+  void SetTableId(table_id_t tid);
+
+  [[nodiscard]] auto GetFieldAt(size_t index) const -> const RTField &;
+
+  [[nodiscard]] auto GetFieldOffset(size_t index) const -> size_t;
+
+  [[nodiscard]] auto GetFieldByName(table_id_t tid, const std::string &name) const -> const RTField &;
+
+  [[nodiscard]] auto GetFieldIndex(table_id_t tid, const std::string &name) const -> size_t;
+
+  /**
+   * get field index according to runtime information
+   * @return
+   */
+  [[nodiscard]] auto GetRTFieldIndex(const RTField &rtfield) const -> size_t;
+
+  [[nodiscard]] auto GetFieldOffset(table_id_t tid, const std::string &name) const -> size_t;
+
+  [[nodiscard]] auto GetRecordLength() const -> size_t;
+
+  [[nodiscard]] auto GetFieldCount() const -> size_t;
+
+  auto HasField(table_id_t tid, const std::string &name) -> bool;
+
+  [[nodiscard]] auto ToString() const -> std::string
+  {
+    std::string str;
+    for (const auto &rtfield : fields_) {
+      str += rtfield.ToString() + ", ";
+    }
+    if (!str.empty()) {
+      str.pop_back();
+      str.pop_back();
+    }
+    return str;
+  }
+
+private:
+  size_t               rec_len_;
+  std::vector<RTField> fields_;
+  std::vector<size_t>  offsets_;
+};
+
+/**
+ * To prevent unexpected changes to a record, Record class is non-volatile (except rid),
+ * if a record-like object is volatile, use RecordSchema + std::vector<ValueSptr> instead
+ */
+class Record
+{
+  friend RecordView;
+
+public:
+  Record() = delete;
+
+  /**
+   * Generate a record from raw data
+   * @param schema
+   * @param null_map_mem
+   * @param data
+   * @param rid
+   */
+  Record(const RecordSchema *schema, const char *null_map_mem, const char *data, RID rid);
+
+  /**
+   * Generate a record from a list of values
+   * @param schema
+   * @param values
+   * @param rid
+   */
+  Record(const RecordSchema *schema, const std::vector<ValueSptr> &values, RID rid);
+
+  /**
+   * Generate a record from another record given the requested schema
+   * @param schema should be a subset of the original schema
+   * @param other the original record, a Record or a view
+   */
+  Record(const RecordSchema *schema, const RecordView &other);
+
+  /**
+   * Generate a record from two records given the requested schema
+   * @param schema should be a combination of the two records' schema
+   * @param rec1 the first record
+   * @param rec2 the second record
+   */
+  Record(const RecordSchema *schema, const RecordView &rec1, const RecordView &rec2);
+
+  /**
+   * Generate a record with all fields set to null
+   * @param schema
+   */
+  explicit Record(const RecordSchema *schema);
+
+  ~Record();
+
+  Record(const Record &record);
+
+  Record &operator=(const Record &record);
+
+  Record(Record &&record) noexcept;
+
+  Record &operator=(Record &&record) noexcept;
+
+  auto operator==(const Record &other) const -> bool;
+
+  [[nodiscard]] auto Hash() const -> size_t;
+
+  void SetRID(const RID &rid) { rid_ = rid; }
+
+  /// Get the RID of this record
+  [[nodiscard]] auto GetRID() const -> RID { return rid_; }
+
+  [[nodiscard]] auto GetValueAt(size_t index) const -> ValueSptr;
+
+  /// Get the schema of this record
+  [[nodiscard]] auto GetSchema() const -> const RecordSchema * { return schema_; }
+
+  [[nodiscard]] auto GetData() const -> const char * { return data_; }
+
+  [[nodiscard]] auto GetNullMap() const -> const char * { return nullmap_; }
+
+  static auto Compare(const Record &lrec, const Record &rrec) -> int;
+
+private:
+  const RecordSchema *schema_;
+  char               *data_;
+  char               *nullmap_;
+  RID                 rid_{};
+};
+
+/**
+ * A record that does not own its memory, it points at the null map and data of a Record, a pinned page or a batch
+ * buffer, and is valid as long as that memory is. Operators hand out views of their current record, a Record is only
+ * materialized by the operators that keep a row beyond Next
+ */
+class RecordView
+{
+public:
+  RecordView() = delete;
+
+  RecordView(const RecordSchema *schema, const char *null_map, const char *data, RID rid)
+      : schema_(schema), nullmap_(null_map), data_(data), rid_(rid)
+  {}
+
+  // NOLINTNEXTLINE(google-explicit-constructor): a record can be passed wherever a view is expected
+  RecordView(const Record &record)
+      : schema_(record.schema_), nullmap_(record.nullmap_), data_(record.data_), rid_(record.rid_)
+  {}
+
+  [[nodiscard]] auto GetSchema() const -> const RecordSchema * { return schema_; }
+
+  [[nodiscard]] auto GetNullMap() const -> const char * { return nullmap_; }
+
+  [[nodiscard]] auto GetData() const -> const char * { return data_; }
+
+  [[nodiscard]] auto GetRID() const -> RID { return rid_; }
+
+  [[nodiscard]] auto IsNull(size_t index) const -> bool { return BitMap::GetBit(nullmap_, index); }
+
+  [[nodiscard]] auto GetValueAt(size_t index) const -> ValueSptr;
+
+  /**
+   * Same schema, null map and data, like Record::operator==, so a view can be a hash map key in place of a Record
+   */
+  auto operator==(const RecordView &other) const -> bool;
+
+  [[nodiscard]] auto Hash() const -> size_t;
+
+  /**
+   * Copy the viewed record into a Record owning its memory
+   */
+  [[nodiscard]] auto ToRecord() const -> RecordUptr;
+
+private:
+  const RecordSchema *schema_;
+  const char         *nullmap_;
+  const char         *data_;
+  RID                 rid_;
+};
+
+/**
+ * Values of one column stored contiguously, so that a column of a PAX page is loaded with one memcpy and scanned
+ * without creating a Value per cell. An int column is an int32_t array, a float column a float array and a char(n)
+ * column n bytes per value, value i is null if bit i of the null bitmap is set
+ */
+class ColumnVector
+{
+public:
+  ColumnVector() = delete;
+
+  /**
+   * Copy size values of the field from data, all of them are not null
+   * @param field
+   * @param data size * field size bytes
+   * @param size
+   */
+  ColumnVector(const RTField &field, const char *data, size_t size);
+
+  [[nodiscard]] auto GetField() const -> const RTField & { return field_; }
+
+  [[nodiscard]] auto GetType() const -> FieldType { return field_.field_.field_type_; }
+
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+
+  /**
+   * Get the values as a typed array, e.g. GetValues<int32_t>() for an int column
+   */
+  template <typename T>
+  [[nodiscard]] auto GetValues() const -> const T *
+  {
+    WSDB_ASSERT(sizeof(T) == field_.field_.field_size_, "value type does not match the field size");
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  [[nodiscard]] auto GetValueData(size_t index) const -> const char *
+  {
+    return data_.data() + index * field_.field_.field_size_;
+  }
+
+  [[nodiscard]] auto IsNull(size_t index) const -> bool { return BitMap::GetBit(nullmap_.data(), index); }
+
+  void SetNull(size_t index, bool is_null) { BitMap::SetBit(nullmap_.data(), index, is_null); }
+
+  [[nodiscard]] auto GetNullMap() const -> const char * { return nullmap_.data(); }
+
+  /**
+   * Create a Value of the value at index, only for callers that work on values
+   */
+  [[nodiscard]] auto GetValueAt(size_t index) const -> ValueSptr;
+
+private:
+  RTField           field_;
+  size_t            size_;
+  std::vector<char> data_;
+  std::vector<char> nullmap_;
+};
+
+/**
+ * A batch of rows stored by column. Columns may hold rows that are not valid, e.g. the empty slots of a page, only the
+ * rows in the selection vector are part of the chunk
+ */
+class Chunk
+{
+public:
+  Chunk() = delete;
+
+  Chunk(const RecordSchema *schema, std::vector<ColumnVector> cols, SelectionVector selection);
+
+  ~Chunk();
+
+  Chunk(const Chunk &chunk);
+
+  Chunk &operator=(const Chunk &chunk);
+
+  Chunk(Chunk &&chunk) noexcept;
+
+  Chunk &operator=(Chunk &&chunk) noexcept;
+
+  [[nodiscard]] auto GetSchema() const -> const RecordSchema * { return schema_; }
+
+  [[nodiscard]] auto GetColumn(size_t index) const -> const ColumnVector & { return cols_[index]; }
+
+  [[nodiscard]] auto GetSelection() const -> const SelectionVector & { return selection_; }
+
+  /**
+   * Get the values of the selected rows of a column as an ArrayValue, creates a Value per row
+   */
+  auto GetCol(int index) -> ArrayValueSptr;
+
+  auto GetColCount() -> size_t;
+
+  /**
+   * @return number of selected rows
+   */
+  [[nodiscard]] auto GetRowCount() const -> size_t { return selection_.size(); }
+
+private:
+  const RecordSchema       *schema_;
+  std::vector<ColumnVector> cols_;
+  SelectionVector           selection_;
+};
+
+}  // namespace wsdb
+
+namespace std {
+template <>
+struct hash<wsdb::Record>
+{
+  auto operator()(const wsdb::Record &record) const -> size_t { return record.Hash(); }
+};
+
+template <>
+struct hash<wsdb::RecordView>
+{
+  auto operator()(const wsdb::RecordView &record) const -> size_t { return record.Hash(); }
+};
+}  // namespace std
+
+#endif  // WSDB_RECORD_MANAGER_H
@@ -0,0 +1,170 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#include "slot_bitmap.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define WSDB_SLOT_BITMAP_AVX2
+#endif
+
+namespace wsdb {
+
+namespace {
+
+struct ByteTables
+{
+  uint8_t slot_order_[256];     // bit i of slot_order_[b] is bit i of byte b as BitMap::GetBit sees it
+  uint8_t positions_[256][8];  // positions of the set bits of a byte in slot order, padded with 0
+  bool    identity_;           // the bits of a byte are already in slot order
+};
+
+auto GetTables() -> const ByteTables &
+{
+  static const ByteTables tables = [] {
+    ByteTables t{};
+    t.identity_ = true;
+    for (int b = 0; b < 256; b++) {
+      char    byte  = static_cast<char>(b);
+      uint8_t order = 0;
+      for (int i = 0; i < 8; i++) {
+        if (BitMap::GetBit(&byte, i)) {
+          order |= static_cast<uint8_t>(1U << i);
+        }
+      }
+      t.slot_order_[b] = order;
+      t.identity_      = t.identity_ && order == b;
+    }
+    for (int b = 0; b < 256; b++) {
+      int cnt = 0;
+      for (int i = 0; i < 8; i++) {
+        if ((b >> i) & 1) {
+          t.positions_[b][cnt++] = static_cast<uint8_t>(i);
+        }
+      }
+    }
+    return t;
+  }();
+  return tables;
+}
+
+// mask of the bits of the word_idx-th word that are below n
+auto WordMask(size_t n, size_t word_idx) -> uint64_t
+{
+  size_t valid = n - word_idx * 64;
+  return valid >= 64 ? ~0ULL : (1ULL << valid) - 1;
+}
+
+auto ToSelectionScalar(const char *bm, size_t n, uint32_t *sel) -> size_t
+{
+  size_t cnt = 0;
+  SlotBitMap::ForEachSet(bm, n, [&](size_t pos) { sel[cnt++] = static_cast<uint32_t>(pos); });
+  return cnt;
+}
+
+#ifdef WSDB_SLOT_BITMAP_AVX2
+// expand a byte at a time: the positions of its set bits come from a table and are widened to 8 uint32_t with one
+// store, the next byte overwrites the padding. A byte only writes below 8 * (its index + 1) since cnt <= 8 * index,
+// so the full bytes never write beyond n, the last partial byte is done in scalar
+__attribute__((target("avx2"))) auto ToSelectionAVX2(const char *bm, size_t n, uint32_t *sel) -> size_t
+{
+  const auto &t          = GetTables();
+  size_t      cnt        = 0;
+  size_t      full_bytes = n / 8;
+  for (size_t i = 0; i < full_bytes; i++) {
+    auto byte = static_cast<uint8_t>(bm[i]);
+    if (byte == 0) {
+      continue;
+    }
+    uint8_t order = t.slot_order_[byte];
+    __m128i pos   = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(t.positions_[order]));
+    __m256i v     = _mm256_add_epi32(_mm256_cvtepu8_epi32(pos), _mm256_set1_epi32(static_cast<int>(i * 8)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sel + cnt), v);
+    cnt += static_cast<size_t>(std::popcount(order));
+  }
+  if (n % 8 != 0) {
+    uint8_t order = t.slot_order_[static_cast<uint8_t>(bm[full_bytes])] & static_cast<uint8_t>((1U << (n % 8)) - 1);
+    for (; order != 0; order &= order - 1) {
+      sel[cnt++] = static_cast<uint32_t>(full_bytes * 8 + std::countr_zero(order));
+    }
+  }
+  return cnt;
+}
+#endif
+
+}  // namespace
+
+auto SlotBitMap::GetWord(const char *bm, size_t n, size_t word_idx) -> uint64_t
+{
+  const auto &t     = GetTables();
+  size_t      first = word_idx * 8;
+  size_t      bytes = std::min<size_t>(8, BITMAP_SIZE(n) - first);
+  uint64_t    word  = 0;
+  if (t.identity_ && std::endian::native == std::endian::little) {
+    std::memcpy(&word, bm + first, bytes);
+  } else {
+    for (size_t i = 0; i < bytes; i++) {
+      word |= static_cast<uint64_t>(t.slot_order_[static_cast<uint8_t>(bm[first + i])]) << (i * 8);
+    }
+  }
+  return word & WordMask(n, word_idx);
+}
+
+auto SlotBitMap::Count(const char *bm, size_t n) -> size_t
+{
+  size_t cnt = 0;
+  for (size_t w = 0; w * 64 < n; w++) {
+    cnt += static_cast<size_t>(std::popcount(GetWord(bm, n, w)));
+  }
+  return cnt;
+}
+
+auto SlotBitMap::FindFirst(const char *bm, size_t n, size_t start, bool value) -> size_t
+{
+  for (size_t w = start / 64; w * 64 < n; w++) {
+    uint64_t word = GetWord(bm, n, w);
+    if (!value) {
+      word = ~word & WordMask(n, w);
+    }
+    if (w == start / 64) {
+      // drop the bits before start
+      word &= ~0ULL << (start % 64);
+    }
+    if (word != 0) {
+      return w * 64 + static_cast<size_t>(std::countr_zero(word));
+    }
+  }
+  return n;
+}
+
+auto SlotBitMap::ToSelection(const char *bm, size_t n, uint32_t *sel) -> size_t
+{
+#ifdef WSDB_SLOT_BITMAP_AVX2
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) {
+    return ToSelectionAVX2(bm, n, sel);
+  }
+#endif
+  return ToSelectionScalar(bm, n, sel);
+}
+
+}  // namespace wsdb
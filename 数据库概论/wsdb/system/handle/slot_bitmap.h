@@ -0,0 +1,77 @@
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+
+
+#ifndef WSDB_SLOT_BITMAP_H
+#define WSDB_SLOT_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include "common/bitmap.h"
+
+namespace wsdb {
+
+/**
+ * Bulk operations on the slot bitmap of a page, a 64-bit word at a time instead of a BitMap call per slot.
+ * The bitmap layout is the one of BitMap, the bits of a byte are mapped to slot order through a table built from
+ * BitMap::GetBit, so nothing here depends on the bit order inside a byte
+ */
+class SlotBitMap
+{
+public:
+  /**
+   * @return number of set bits among the first n bits
+   */
+  static auto Count(const char *bm, size_t n) -> size_t;
+
+  /**
+   * Find the first bit equal to value from start on
+   * @return its position, n if there is none
+   */
+  static auto FindFirst(const char *bm, size_t n, size_t start, bool value) -> size_t;
+
+  /**
+   * Get the word_idx-th 64 bits of the bitmap in slot order, bit i of the word is bit word_idx * 64 + i of the bitmap,
+   * the bits beyond n are 0
+   */
+  static auto GetWord(const char *bm, size_t n, size_t word_idx) -> uint64_t;
+
+  /**
+   * Call f(pos) for every set bit among the first n bits in ascending order
+   */
+  template <typename F>
+  static void ForEachSet(const char *bm, size_t n, F &&f)
+  {
+    for (size_t w = 0; w * 64 < n; w++) {
+      for (uint64_t word = GetWord(bm, n, w); word != 0; word &= word - 1) {
+        f(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+      }
+    }
+  }
+
+  /**
+   * Write the positions of the set bits among the first n bits to sel in ascending order, with AVX2 if the CPU has it
+   * @param sel room for n positions
+   * @return number of positions written
+   */
+  static auto ToSelection(const char *bm, size_t n, uint32_t *sel) -> size_t;
+};
+
+}  // namespace wsdb
+
+#endif  // WSDB_SLOT_BITMAP_H
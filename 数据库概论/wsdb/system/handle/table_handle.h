@@ -1,178 +1,283 @@
-/*------------------------------------------------------------------------------
- - Copyright (c) 2024. Websoft research group, Nanjing University.
- -
- - This program is free software: you can redistribute it and/or modify
- - it under the terms of the GNU General Public License as published by
- - the Free Software Foundation, either version 3 of the License, or
- - (at your option) any later version.
- -
- - This program is distributed in the hope that it will be useful,
- - but WITHOUT ANY WARRANTY; without even the implied warranty of
- - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- - GNU General Public License for more details.
- -
- - You should have received a copy of the GNU General Public License
- - along with this program.  If not, see <https://www.gnu.org/licenses/>.
- -----------------------------------------------------------------------------*/
-
-//
-// Created by ziqi on 2024/7/19.
-//
-
-#ifndef WSDB_TABLE_HANDLE_H
-#define WSDB_TABLE_HANDLE_H
-#include <utility>
-
-#include "../../../common/micro.h"
-#include "common/page.h"
-#include "storage/storage.h"
-#include "page_handle.h"
-
-namespace wsdb {
-
-/**
- * Table descriptor in memory, including the column schema of the table
- */
-class TableHandle
-{
-public:
-  TableHandle() = delete;
-
-  TableHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, table_id_t table_id, TableHeader &hdr,
-      RecordSchemaUptr &schema, StorageModel storage_model);
-
-  /**
-   * Get a record by rid
-   * 1. fetch the page handle by rid
-   * 2. check if there is a record in the slot using bitmap, if not, unpin the page and throw WSDB_RECORD_MISS
-   * 3. read the record from the slot using page handle
-   * 4. unpin the page
-   * @param rid
-   * @return record
-   */
-  auto GetRecord(const RID &rid) -> RecordUptr;
-
-  /**
-   * Get a chunk in page using record schema indicating which columns should be loaded
-   * @param pid
-   * @param chunk_schema
-   * @return
-   */
-  auto GetChunk(page_id_t pid, const RecordSchema *chunk_schema) -> ChunkUptr;
-
-  /**
-   * Insert a record into the table
-   * 1. create a page handle using CreatePageHandle
-   * 2. get an empty slot in the page
-   * 3. write the record into the slot
-   * 4. update the bitmap and the number of records in the page header
-   * 5. if the page is full after inserting the record, update the first free page id in the file header and set the
-   * next page id of the current page
-   * 6. unpin the page
-   * @param record
-   * @return rid of the inserted record
-   */
-  auto InsertRecord(const Record &record) -> RID;
-
-  /**
-   * Insert a record into the table given rid
-   * 1. if rid is invalid, unpin the page and throw WSDB_PAGE_MISS
-   * 2. fetch the page handle and check the bitmap, if the slot is not empty, throw WSDB_RECORD_EXISTS
-   * 3. do the rest of the steps in InsertRecord 3-6
-   * @param rid
-   * @param record
-   */
-  void InsertRecord(const RID &rid, const Record &record);
-
-  /**
-   * Delete the record by rid
-   * 1. if the slot is empty, unpin the page and throw WSDB_RECORD_MISS
-   * 2. update the bitmap and the number of records in the page header
-   * 3. if the page is not full after deleting the record, update the first free page id in the file header and the next
-   * page id in the page header
-   * 4. unpin the page
-   * @param rid
-   */
-  void DeleteRecord(const RID &rid);
-
-  /**
-   * Update the record by rid
-   * 1. if the slot is empty, unpin the page and throw WSDB_RECORD_MISS
-   * 2. write slot
-   * 3. unpin the page
-   * @param rid
-   * @param record
-   */
-  void UpdateRecord(const RID &rid, const Record &record);
-
-  [[nodiscard]] auto GetTableId() const -> table_id_t;
-
-  [[nodiscard]] auto GetTableHeader() const -> const TableHeader &;
-
-  [[nodiscard]] auto GetSchema() const -> const RecordSchema &;
-
-  [[nodiscard]] auto GetTableName() const -> std::string;
-
-  [[nodiscard]] auto GetStorageModel() const -> StorageModel;
-
-  [[nodiscard]] auto GetFirstRID() -> RID;
-
-  [[nodiscard]] auto GetNextRID(const RID &rid) -> RID;
-
-  [[nodiscard]] auto HasField(const std::string &field_name) const -> bool;
-
-private:
-  /**
-   * Fetch the page handle by page id
-   * @param page_id
-   * @return
-   */
-  auto FetchPageHandle(page_id_t page_id) -> PageHandleUptr;
-
-  /**
-   * Create a page handle that has at least one empty slot
-   * @return
-   */
-  auto CreatePageHandle() -> PageHandleUptr;
-
-  /**
-   * Create a fresh new page handle
-   * @return
-   */
-  auto CreateNewPageHandle() -> PageHandleUptr;
-
-  /**
-   * Wrap the page handle according to the storage model
-   * @param page
-   * @return
-   */
-  auto WrapPageHandle(Page *page) -> PageHandleUptr;
-
-private:
-  TableHeader tab_hdr_;
-  table_id_t  table_id_;
-
-  DiskManager       *disk_manager_;
-  BufferPoolManager *buffer_pool_manager_;
-
-  RecordSchemaUptr schema_;
-  StorageModel     storage_model_;
-
-  /// field below is available when storage model is pax
-  // field offsets is the offset of each field stored in page
-  // pax model is stored like below, field_offset can be calculated by Record Schema
-  // | page header | bitmap |
-  // slot memery begins
-  // | nullmap_1, nullmap_2, ... , nullmap_n|
-  // | field_1_1, field_1_2, ... , field_1_n |
-  // | field_2_1, field_2_2, ... , field_2_n |
-  // ...
-  // | field_m_1, field_m_2, ... , field_m_n |
-  std::vector<size_t> field_offset_;
-};
-
-DEFINE_UNIQUE_PTR(TableHandle);
-
-}  // namespace wsdb
-
-#endif  // WSDB_TABLE_HANDLE_H
+/*------------------------------------------------------------------------------
+ - Copyright (c) 2024. Websoft research group, Nanjing University.
+ -
+ - This program is free software: you can redistribute it and/or modify
+ - it under the terms of the GNU General Public License as published by
+ - the Free Software Foundation, either version 3 of the License, or
+ - (at your option) any later version.
+ -
+ - This program is distributed in the hope that it will be useful,
+ - but WITHOUT ANY WARRANTY; without even the implied warranty of
+ - MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ - GNU General Public License for more details.
+ -
+ - You should have received a copy of the GNU General Public License
+ - along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ -----------------------------------------------------------------------------*/
+
+//
+// Created by ziqi on 2024/7/19.
+//
+
+#ifndef WSDB_TABLE_HANDLE_H
+#define WSDB_TABLE_HANDLE_H
+#include <utility>
+
+#include "../../../common/micro.h"
+#include "common/page.h"
+#include "storage/storage.h"
+#include "page_handle.h"
+
+namespace wsdb {
+
+// a table file grows by extents of this many pages, allocated ahead of the pages appended to it
+static constexpr size_t TABLE_EXTENT_PAGES = 64;
+
+/**
+ * The records of one page copied out by TableHandle::ReadPageRecords, record i is in slot slots_[i], its null map and
+ * data are at i * nullmap size and i * record size
+ */
+struct PageRecords
+{
+  SelectionVector   slots_;
+  std::vector<char> nullmaps_;
+  std::vector<char> data_;
+};
+
+/**
+ * Table descriptor in memory, including the column schema of the table.
+ * Pages are accessed through page handles owning a page guard, so a page is unpinned as soon as its handle is
+ * destroyed, also when an exception is thrown. Readers of a page share its latch, writers take it exclusively
+ */
+class TableHandle
+{
+public:
+  TableHandle() = delete;
+
+  TableHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, table_id_t table_id, TableHeader &hdr,
+      RecordSchemaUptr &schema, StorageModel storage_model);
+
+  /**
+   * Get a record by rid
+   * 1. fetch the page handle by rid
+   * 2. check if there is a record in the slot using bitmap, if not, throw WSDB_RECORD_MISS
+   * 3. read the record from the slot using page handle
+   * 4. unpin the page
+   * @param rid
+   * @param strategy buffer access strategy of the scan, see GetAccessStrategy
+   * @return record
+   */
+  auto GetRecord(const RID &rid, BufferAccessStrategy *strategy = nullptr) -> RecordUptr;
+
+  /**
+   * Get a chunk in page using record schema indicating which columns should be loaded
+   * @param pid
+   * @param chunk_schema
+   * @param strategy buffer access strategy of the scan, see GetAccessStrategy
+   * @return
+   */
+  auto GetChunk(page_id_t pid, const RecordSchema *chunk_schema, BufferAccessStrategy *strategy = nullptr)
+      -> ChunkUptr;
+
+  /**
+   * Insert a record into the table
+   * 1. create a page handle using CreatePageHandle
+   * 2. get an empty slot in the page
+   * 3. write the record into the slot
+   * 4. update the bitmap and the number of records in the page header
+   * 5. if the page is full after inserting the record, update the first free page id in the file header and set the
+   * next page id of the current page
+   * 6. unpin the page
+   * @param record
+   * @param strategy buffer access strategy of a bulk load, see GetAccessStrategy
+   * @return rid of the inserted record
+   */
+  auto InsertRecord(const Record &record, BufferAccessStrategy *strategy = nullptr) -> RID;
+
+  /**
+   * Insert a record into the table given rid
+   * 1. if rid is invalid, throw WSDB_PAGE_MISS
+   * 2. fetch the page handle and check the bitmap, if the slot is not empty, throw WSDB_RECORD_EXISTS
+   * 3. do the rest of the steps in InsertRecord 3-6
+   * @param rid
+   * @param record
+   */
+  void InsertRecord(const RID &rid, const Record &record);
+
+  /**
+   * Delete the record by rid
+   * 1. if the slot is empty, unpin the page and throw WSDB_RECORD_MISS
+   * 2. update the bitmap and the number of records in the page header
+   * 3. if the page is not full after deleting the record, update the first free page id in the file header and the next
+   * page id in the page header
+   * 4. unpin the page
+   * @param rid
+   */
+  void DeleteRecord(const RID &rid);
+
+  /**
+   * Update the record by rid
+   * 1. if the slot is empty, unpin the page and throw WSDB_RECORD_MISS
+   * 2. write slot
+   * 3. unpin the page
+   * @param rid
+   * @param record
+   */
+  void UpdateRecord(const RID &rid, const Record &record);
+
+  [[nodiscard]] auto GetTableId() const -> table_id_t;
+
+  [[nodiscard]] auto GetTableHeader() const -> const TableHeader &;
+
+  [[nodiscard]] auto GetSchema() const -> const RecordSchema &;
+
+  [[nodiscard]] auto GetTableName() const -> std::string;
+
+  [[nodiscard]] auto GetStorageModel() const -> StorageModel;
+
+  [[nodiscard]] auto GetFirstRID(BufferAccessStrategy *strategy = nullptr) -> RID;
+
+  [[nodiscard]] auto GetNextRID(const RID &rid, BufferAccessStrategy *strategy = nullptr) -> RID;
+
+  /**
+   * Copy all the records of a page out with one fetch of the page
+   * @param pid
+   * @param records cleared and filled in slot order, empty if the page has no record
+   * @param strategy
+   */
+  void ReadPageRecords(page_id_t pid, PageRecords &records, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Get a buffer access strategy for a scan or a bulk load touching num_pages pages of the table, so that it does
+   * not flush the working set of other queries out of the buffer pool
+   * @param type
+   * @param num_pages number of pages going to be accessed
+   * @return the strategy, nullptr if the pages fit comfortably in the buffer pool (no more than 1/4 of it)
+   */
+  [[nodiscard]] auto GetAccessStrategy(BufferAccessType type, size_t num_pages) const -> BufferAccessStrategyUptr;
+
+  [[nodiscard]] auto HasField(const std::string &field_name) const -> bool;
+
+private:
+  /**
+   * Fetch the page handle by page id for reading, the page is latched shared
+   * @param page_id
+   * @param strategy
+   * @return
+   */
+  auto FetchPageHandle(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) -> PageHandleUptr;
+
+  /**
+   * Fetch the page handle by page id for writing, the page is latched exclusively and unpinned dirty
+   * @param page_id
+   * @param strategy
+   * @return
+   */
+  auto FetchWritablePageHandle(page_id_t page_id, BufferAccessStrategy *strategy = nullptr) -> PageHandleUptr;
+
+  /**
+   * Create a page handle that has at least one empty slot
+   * @return
+   */
+  auto CreatePageHandle(BufferAccessStrategy *strategy = nullptr) -> PageHandleUptr;
+
+  /**
+   * Create a fresh new page handle, the page is appended to the file without reading it and the file is extended by
+   * TABLE_EXTENT_PAGES when it runs out of allocated pages
+   * @return
+   */
+  auto CreateNewPageHandle(BufferAccessStrategy *strategy = nullptr) -> PageHandleUptr;
+
+  /**
+   * Wrap the page handle according to the storage model, the handle takes the guard over
+   * @param guard
+   * @return
+   */
+  auto WrapPageHandle(PageGuard &&guard) -> PageHandleUptr;
+
+private:
+  TableHeader tab_hdr_;
+  table_id_t  table_id_;
+  size_t      allocated_page_num_;  // pages on disk or allocated beyond the end of the file by AllocatePages
+
+  DiskManager       *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  RecordSchemaUptr schema_;
+  StorageModel     storage_model_;
+
+  /// field below is available when storage model is pax
+  // field offsets is the offset of each field stored in page
+  // pax model is stored like below, field_offset can be calculated by Record Schema
+  // | page header | bitmap |
+  // slot memery begins
+  // | nullmap_1, nullmap_2, ... , nullmap_n|
+  // | field_1_1, field_1_2, ... , field_1_n |
+  // | field_2_1, field_2_2, ... , field_2_n |
+  // ...
+  // | field_m_1, field_m_2, ... , field_m_n |
+  std::vector<size_t> field_offset_;
+};
+
+DEFINE_UNIQUE_PTR(TableHandle);
+
+/**
+ * Sequential scan over the records of a table a page at a time. Every page is fetched once, its records are copied out
+ * by ReadPageRecords and the page is released before they are handed out, so the consumer may modify the table
+ * meanwhile without holding the page latch
+ */
+class TableScan
+{
+public:
+  TableScan() = delete;
+
+  /**
+   * Position the scan on the first record of the table
+   * @param tab
+   * @param strategy buffer access strategy of the scan, must outlive the scan
+   */
+  TableScan(TableHandle *tab, BufferAccessStrategy *strategy);
+
+  [[nodiscard]] auto IsEnd() const -> bool { return pos_ >= records_.slots_.size(); }
+
+  /**
+   * Move to the next record, loading the next page that has records when the current one is done
+   */
+  void Next();
+
+  [[nodiscard]] auto GetRID() const -> RID { return {page_id_, static_cast<slot_id_t>(records_.slots_[pos_])}; }
+
+  [[nodiscard]] auto GetNullMap() const -> const char *
+  {
+    return records_.nullmaps_.data() + pos_ * tab_->GetTableHeader().nullmap_size_;
+  }
+
+  [[nodiscard]] auto GetData() const -> const char *
+  {
+    return records_.data_.data() + pos_ * tab_->GetTableHeader().rec_size_;
+  }
+
+  /**
+   * Create a record of the current position
+   */
+  [[nodiscard]] auto GetRecord() const -> RecordUptr;
+
+private:
+  /**
+   * Load the records of the first page from next_pid_ on that has records
+   */
+  void LoadNextPage();
+
+  TableHandle          *tab_;
+  BufferAccessStrategy *strategy_;
+  page_id_t             page_id_{INVALID_PAGE_ID};  // page of the loaded records
+  page_id_t             next_pid_;
+  PageRecords           records_;
+  size_t                pos_{0};
+};
+
+DEFINE_UNIQUE_PTR(TableScan);
+
+}  // namespace wsdb
+
+#endif  // WSDB_TABLE_HANDLE_H